@@ -231,7 +231,8 @@ void subscriptionPost(GroupSourceSubscriptionCtx *pGroupCtx)
         return;
 
     // If events have been primed then return the value to the subscriber,
-    // and unmark all accumulated changes
+    // and unmark all accumulated changes.
+    // clone() of an identical type copies only marked fields, by offset.
     pGroupCtx->subscriptionControl->post(currentValue.clone());
     currentValue.unmark();
 }
@@ -247,10 +247,11 @@ void dbpvar(const char *precordname, int level)
                     printf("%s\t", chan->key.first.c_str());
                 }
 
-                printf("conn=%c %zu disconnects, %zu type changes",
+                printf("conn=%c %zu disconnects, %zu type changes, %zu batched",
                        chan->connected?'T':'F',
                        chan->num_disconnect,
-                       chan->num_type_change);
+                       chan->num_type_change,
+                       chan->num_batched);
                 if(chan->op_put) {
                     printf(" Put");
                 }
@@ -310,6 +311,20 @@ void dbpvar(const char *precordname, int level)
         printf("  %zu/%zu channels connected used by %zu links\n",
                nconn, nchans, nlinks);
 
+        if(level>=1) {
+            for(auto& worker : linkGlobal->workers) {
+                auto depth(worker->queue.size());
+                Guard G(worker->lock);
+                printf("  worker %zu queue=%zu max=%zu runs=%zu",
+                       worker->index, depth, worker->maxQueue, worker->nrun);
+                if(worker->nrun)
+                    printf(" wait avg/max=%.1f/%.1f us run avg/max=%.1f/%.1f us",
+                           worker->waitTotal*1e-3/worker->nrun, worker->waitMax*1e-3,
+                           worker->runTotal*1e-3/worker->nrun, worker->runMax*1e-3);
+                printf("\n");
+            }
+        }
+
     } catch(std::exception& e) {
         fprintf(stderr, "Error: %s\n", e.what());
     }
@@ -9,6 +9,8 @@
 
 #include <set>
 #include <map>
+#include <memory>
+#include <vector>
 
 #define EPICS_DBCA_PRIVATE_API
 #include <epicsGuard.h>
@@ -103,10 +105,46 @@ struct pvaLinkConfig : public jlink
     virtual ~pvaLinkConfig();
 };
 
-struct linkGlobal_t final : private epicsThreadRunable {
+// One of linkGlobal_t::workers.  Each pvaLinkChannel is assigned to one worker,
+// so that its updates are never processed concurrently.
+struct linkWorker_t final : private epicsThreadRunable {
+    const size_t index;
+
+    struct Work {
+        std::weak_ptr<epicsThreadRunable> what;
+        epicsUInt64 queued; // epicsMonotonicGet() when pushed
+    };
+    MPMCFIFO<Work> queue;
+
+    // guards further members
+    epicsMutex lock;
+    bool workerStop = false;
+
+    // statistics, cf. dbpvar().  times in ns
+    size_t maxQueue = 0u;
+    size_t nrun = 0u;
+    epicsUInt64 waitTotal = 0u, waitMax = 0u;
+    epicsUInt64 runTotal = 0u, runMax = 0u;
+
+private:
+    epicsThread worker;
+    virtual void run() override final;
+public:
+
+    explicit linkWorker_t(size_t index);
+    linkWorker_t(const linkWorker_t&) = delete;
+    linkWorker_t& operator=(const linkWorker_t&) = delete;
+    virtual ~linkWorker_t();
+
+    void push(const std::shared_ptr<epicsThreadRunable>& work);
+    void close();
+};
+
+struct linkGlobal_t final {
     client::Context provider_remote;
 
-    MPMCFIFO<std::weak_ptr<epicsThreadRunable>> queue;
+    // pvaLinkNWorkers entries
+    std::vector<std::unique_ptr<linkWorker_t>> workers;
 
     epicsMutex lock;
 
@@ -122,18 +160,18 @@ struct linkGlobal_t final : private epicsThreadRunable {
     // pvRequest used with PUT
     const Value putReq;
 
-private:
-    epicsThread worker;
-    bool workerStop = false;
-    virtual void run() override final;
-public:
+    // round robin assignment of new channels to workers
+    size_t nextWorker = 0u;
 
     linkGlobal_t();
     linkGlobal_t(const linkGlobal_t&) = delete;
     linkGlobal_t& operator=(const linkGlobal_t&) = delete;
-    virtual ~linkGlobal_t();
+    ~linkGlobal_t();
     void close();
 
+    // call with lock held
+    linkWorker_t* pickWorker();
+
     // IOC lifecycle hooks
     static void alloc();
     static void init();
@@ -147,6 +185,8 @@ struct pvaLinkChannel final : public epicsThreadRunable
 {
     const linkGlobal_t::channels_key_t key; // tuple of (channelName, pvRequest key)
     const Value pvRequest; // used with monitor
+    // runs all queued work for this channel
+    linkWorker_t* const worker;
 
     INST_COUNTER(pvaLinkChannel);
 
@@ -159,6 +199,8 @@ struct pvaLinkChannel final : public epicsThreadRunable
     Value root;
 
     size_t num_disconnect = 0u, num_type_change = 0u;
+    // updates merged into a previous update of the same batch, without their own record processing
+    size_t num_batched = 0u;
 
     bool connected = false;
     bool debug = false; // set if any jlink::debug is set
@@ -213,6 +255,9 @@ private:
     std::vector<ScanTrack> nonatomic_records,
                            atomic_records;
 
+    // updates dequeued together
+    std::vector<Value> batch;
+
     ioc::DBManyLock atomic_lock;
 };
 
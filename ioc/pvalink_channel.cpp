@@ -4,9 +4,13 @@
  * in file LICENSE that is included with this distribution.
  */
 
+#define PVXS_ENABLE_EXPERT_API
+
 #include <alarm.h>
 #include <sstream>
 
+#include <epicsTime.h>
+
 #include <pvxs/log.h>
 
 #include "utilpvt.h"
@@ -25,37 +29,48 @@ namespace ioc {
 linkGlobal_t *linkGlobal;
 
 
-linkGlobal_t::linkGlobal_t()
-    :queue()
-    ,running(false)
-    ,putReq(TypeDef(TypeCode::Struct, {
-                        members::Struct("field", {}),
-                        members::Struct("record", {
-                            members::Struct("_options", {
-                                members::Bool("block"),
-                                members::String("process"),
-                            }),
-                        }),                       }).create())
+linkWorker_t::linkWorker_t(size_t index)
+    :index(index)
     ,worker(*this,
-            "pvxlink",
+            std::string(SB()<<"pvxlink"<<index).c_str(),
             epicsThreadGetStackSize(epicsThreadStackBig),
             // worker should be above PVA worker priority?
             epicsThreadPriorityMedium)
 {
-    // TODO respect pvaLinkNWorkers?
     worker.start();
 }
 
-linkGlobal_t::~linkGlobal_t()
+linkWorker_t::~linkWorker_t() {}
+
+void linkWorker_t::push(const std::shared_ptr<epicsThreadRunable>& work)
 {
+    queue.push(Work{work, epicsMonotonicGet()});
+
+    auto depth(queue.size());
+    Guard G(lock);
+    if(maxQueue < depth)
+        maxQueue = depth;
 }
 
-void linkGlobal_t::run()
+void linkWorker_t::run()
 {
     while(1) {
         auto w = queue.pop();
-        if(auto chan = w.lock()) {
+        if(auto chan = w.what.lock()) {
+            auto start(epicsMonotonicGet());
             chan->run();
+            auto end(epicsMonotonicGet());
+
+            Guard G(lock);
+            nrun++;
+            auto wait(start - w.queued);
+            waitTotal += wait;
+            if(waitMax < wait)
+                waitMax = wait;
+            auto dur(end - start);
+            runTotal += dur;
+            if(runMax < dur)
+                runMax = dur;
         }
         {
             Guard G(lock);
@@ -63,19 +78,52 @@ void linkGlobal_t::run()
                 break;
         }
     }
-
 }
 
-void linkGlobal_t::close()
+void linkWorker_t::close()
 {
     {
         Guard G(lock);
         workerStop = true;
     }
-    queue.push(std::weak_ptr<epicsThreadRunable>());
+    queue.push(Work{});
     worker.exitWait();
 }
 
+linkGlobal_t::linkGlobal_t()
+    :running(false)
+    ,putReq(TypeDef(TypeCode::Struct, {
+                        members::Struct("field", {}),
+                        members::Struct("record", {
+                            members::Struct("_options", {
+                                members::Bool("block"),
+                                members::String("process"),
+                            }),
+                        }),                       }).create())
+{
+    auto nworkers = pvaLinkNWorkers > 0 ? size_t(pvaLinkNWorkers) : 1u;
+    workers.reserve(nworkers);
+    for(auto i : range(nworkers))
+        workers.emplace_back(new linkWorker_t(i));
+}
+
+linkGlobal_t::~linkGlobal_t()
+{
+}
+
+void linkGlobal_t::close()
+{
+    for(auto& worker : workers)
+        worker->close();
+}
+
+linkWorker_t* linkGlobal_t::pickWorker()
+{
+    auto ret = workers[nextWorker % workers.size()].get();
+    nextWorker = (nextWorker + 1u) % workers.size();
+    return ret;
+}
+
 DEFINE_INST_COUNTER(pvaLinkChannel);
 DEFINE_INST_COUNTER(pvaLink);
 
@@ -89,6 +137,7 @@ bool pvaLinkChannel::LinkSort::operator()(const pvaLink *L, const pvaLink *R) co
 pvaLinkChannel::pvaLinkChannel(const linkGlobal_t::channels_key_t &key, const Value& pvRequest)
     :key(key)
     ,pvRequest(pvRequest)
+    ,worker(linkGlobal->pickWorker())
     ,AP(new AfterPut)
 {}
 
@@ -115,7 +164,7 @@ void pvaLinkChannel::open()
     {
         log_debug_printf(_logger, "Monitor %s wakeup\n", key.first.c_str());
         try {
-            linkGlobal->queue.push(shared_from_this());
+            worker->push(shared_from_this());
         }catch(std::bad_weak_ptr&){
             log_err_printf(_logger, "channel '%s' open during dtor?", key.first.c_str());
         }
@@ -212,7 +261,7 @@ void linkPutDone(pvaLinkChannel *self, client::Result&& result)
     log_debug_printf(_logger, "linkPutDone: %s, needscans = %i\n", self->key.first.c_str(), needscans);
 
     if(needscans) {
-        linkGlobal->queue.push(self->AP);
+        self->worker->push(self->AP);
     }
 }
 
@@ -324,36 +373,40 @@ void pvaLinkChannel::ScanTrack::scan()
     }
 }
 
-// Running from global WorkQueue thread
+// Running from the linkWorker_t assigned to this channel
 void pvaLinkChannel::run()
 {
+    bool more = false;
     {
         Guard G(lock);
 
         log_debug_printf(_logger,"Monitor %s work\n", this->key.first.c_str());
 
-        Value top;
         try {
-            top = op_mon->pop();
-            if(!top) {
+            more = op_mon->pop(batch);
+            if(batch.empty()) {
                 log_debug_printf(_logger, "Monitor %s empty\n", this->key.first.c_str());
                 return;
             }
+            auto it(batch.begin());
             if(!connected) {
                 // (re)connect implies type change
                 log_debug_printf(_logger, "Monitor %s reconnect\n", this->key.first.c_str());
 
-                root = top; // re-create cache
+                root = *it++; // re-create cache
                 connected = true;
                 num_type_change++;
 
                 for(auto link : links) {
                     link->onTypeChange();
                 }
-
-            } else { // update cache
-                root.assign(top);
             }
+            // update cache.  only marked fields are copied
+            for(auto end(batch.end()); it!=end; ++it)
+                root.assign(*it);
+            num_batched += batch.size()-1u;
+            batch.clear();
+
             log_debug_printf(_logupdate, "Monitor %s value %s\n", this->key.first.c_str(),
                              std::string(SB()<<root.format().delta().arrayLimit(5u)).c_str());
 
@@ -375,8 +428,11 @@ void pvaLinkChannel::run()
             // Don't clear previous_root on disconnect.
             // while disconnected, we will provide the most recent value w/ LINK_ALARM
 
+            more = true; // check for (re)connect
+
         } catch(std::exception& e) {
             log_exc_printf(_logger, "pvalinkChannel::run: Unexpected exception: %s\n", e.what());
+            more = true;
         }
 
         if(links_changed) {
@@ -431,9 +487,11 @@ void pvaLinkChannel::run()
         trac.scan();
     }
 
-    log_debug_printf(_logger, "Requeueing %s\n", key.first.c_str());
-    // re-queue until monitor queue is empty
-    linkGlobal->queue.push(shared_from_this());
+    if(more) {
+        log_debug_printf(_logger, "Requeueing %s\n", key.first.c_str());
+        // re-queue until monitor queue is empty.  Otherwise wait for the next event callback
+        worker->push(shared_from_this());
+    }
 }
 
 }} // namespace pvxs::ioc
@@ -0,0 +1,228 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#  define PVXS_SWAP_SSE2
+#  include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || __GNUC__>=5)
+#  define PVXS_SWAP_AVX2
+#  include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define PVXS_SWAP_NEON
+#  include <arm_neon.h>
+#endif
+
+#include "pvaproto.h"
+
+namespace pvxs {namespace impl {
+
+namespace {
+
+typedef void (*swap_fn)(uint8_t* dest, const uint8_t* src, size_t nbytes);
+
+struct SwapImpl {
+    const char* name;
+    swap_fn swap2, swap4, swap8;
+};
+
+template<unsigned N>
+void swapScalar(uint8_t* dest, const uint8_t* src, size_t nbytes)
+{
+    for(size_t i=0u; i<nbytes; i+=N) {
+        uint8_t temp[N]; // allows dest==src
+        for(unsigned n=0u; n<N; n++)
+            temp[N-1u-n] = src[i+n];
+        memcpy(dest+i, temp, N);
+    }
+}
+
+#ifdef PVXS_SWAP_SSE2
+// SSE2 has no byte shuffle.  Swap bytes within 16-bit words by shifting,
+// after re-ordering 16-bit words.
+inline
+__m128i sse2Swap16(__m128i v)
+{
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+template<unsigned N> __m128i sse2Swap(__m128i v);
+template<> inline __m128i sse2Swap<2u>(__m128i v)
+{
+    return sse2Swap16(v);
+}
+template<> inline __m128i sse2Swap<4u>(__m128i v)
+{
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    return sse2Swap16(v);
+}
+template<> inline __m128i sse2Swap<8u>(__m128i v)
+{
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+    v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+    return sse2Swap16(v);
+}
+
+template<unsigned N>
+void swapSSE2(uint8_t* dest, const uint8_t* src, size_t nbytes)
+{
+    size_t i=0u;
+    for(; i+16u<=nbytes; i+=16u) {
+        auto v(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest+i), sse2Swap<N>(v));
+    }
+    swapScalar<N>(dest+i, src+i, nbytes-i);
+}
+
+const SwapImpl implSSE2{"SSE2", &swapSSE2<2u>, &swapSSE2<4u>, &swapSSE2<8u>};
+#endif // PVXS_SWAP_SSE2
+
+#ifdef PVXS_SWAP_AVX2
+template<unsigned N>
+__attribute__((target("avx2")))
+void swapAVX2(uint8_t* dest, const uint8_t* src, size_t nbytes)
+{
+    // shuffle within each 16 byte lane
+    uint8_t order[32];
+    for(unsigned j=0u; j<32u; j++)
+        order[j] = uint8_t((j%16u)/N*N + (N-1u - j%N));
+    const auto mask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(order)));
+
+    size_t i=0u;
+    for(; i+32u<=nbytes; i+=32u) {
+        auto v(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src+i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest+i), _mm256_shuffle_epi8(v, mask));
+    }
+    swapScalar<N>(dest+i, src+i, nbytes-i);
+}
+
+const SwapImpl implAVX2{"AVX2", &swapAVX2<2u>, &swapAVX2<4u>, &swapAVX2<8u>};
+#endif // PVXS_SWAP_AVX2
+
+#ifdef PVXS_SWAP_NEON
+template<unsigned N> uint8x16_t neonSwap(uint8x16_t v);
+template<> inline uint8x16_t neonSwap<2u>(uint8x16_t v) { return vrev16q_u8(v); }
+template<> inline uint8x16_t neonSwap<4u>(uint8x16_t v) { return vrev32q_u8(v); }
+template<> inline uint8x16_t neonSwap<8u>(uint8x16_t v) { return vrev64q_u8(v); }
+
+template<unsigned N>
+void swapNEON(uint8_t* dest, const uint8_t* src, size_t nbytes)
+{
+    size_t i=0u;
+    for(; i+16u<=nbytes; i+=16u) {
+        vst1q_u8(dest+i, neonSwap<N>(vld1q_u8(src+i)));
+    }
+    swapScalar<N>(dest+i, src+i, nbytes-i);
+}
+
+const SwapImpl implNEON{"NEON", &swapNEON<2u>, &swapNEON<4u>, &swapNEON<8u>};
+#endif // PVXS_SWAP_NEON
+
+const SwapImpl implScalar{"scalar", &swapScalar<2u>, &swapScalar<4u>, &swapScalar<8u>};
+
+// usable on this CPU, most preferred first
+std::vector<const SwapImpl*> availableSwap()
+{
+    std::vector<const SwapImpl*> ret;
+#ifdef PVXS_SWAP_AVX2
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+        ret.push_back(&implAVX2);
+#endif
+#ifdef PVXS_SWAP_NEON
+    ret.push_back(&implNEON);
+#endif
+#ifdef PVXS_SWAP_SSE2
+    ret.push_back(&implSSE2);
+#endif
+    ret.push_back(&implScalar);
+    return ret;
+}
+
+const SwapImpl* selectSwap()
+{
+    return availableSwap().front();
+}
+
+// selection is idempotent, so a race on first use is harmless
+std::atomic<const SwapImpl*> swapImpl{nullptr};
+
+const SwapImpl* currentSwap()
+{
+    auto impl = swapImpl.load(std::memory_order_acquire);
+    if(!impl) {
+        impl = selectSwap();
+        swapImpl.store(impl, std::memory_order_release);
+    }
+    return impl;
+}
+
+void swapWith(const SwapImpl* impl, void* dest, const void* src, size_t nbytes, size_t esize)
+{
+    auto d = static_cast<uint8_t*>(dest);
+    auto s = static_cast<const uint8_t*>(src);
+
+    switch(esize) {
+    case 1u:
+        if(d!=s)
+            memcpy(d, s, nbytes);
+        break;
+    case 2u: (*impl->swap2)(d, s, nbytes); break;
+    case 4u: (*impl->swap4)(d, s, nbytes); break;
+    case 8u: (*impl->swap8)(d, s, nbytes); break;
+    default:
+        if(d!=s)
+            memcpy(d, s, nbytes);
+        for(size_t i=0u; i<nbytes; i+=esize)
+            std::reverse(d+i, d+i+esize);
+        break;
+    }
+}
+
+} // namespace
+
+void swapCopy(void* dest, const void* src, size_t nbytes, size_t esize)
+{
+    swapWith(currentSwap(), dest, src, nbytes, esize);
+}
+
+const char* swapCopyImpl()
+{
+    return currentSwap()->name;
+}
+
+std::vector<std::string> swapCopyImpls()
+{
+    std::vector<std::string> ret;
+    for(auto impl : availableSwap())
+        ret.emplace_back(impl->name);
+    return ret;
+}
+
+void swapCopyWith(const std::string& name, void* dest, const void* src, size_t nbytes, size_t esize)
+{
+    for(auto impl : availableSwap()) {
+        if(name==impl->name) {
+            swapWith(impl, dest, src, nbytes, esize);
+            return;
+        }
+    }
+    throw std::logic_error("Unknown or unsupported swapCopy() implementation");
+}
+
+}} // namespace pvxs::impl
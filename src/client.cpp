@@ -50,6 +50,15 @@ constexpr size_t nBuckets = 30u;
  */
 constexpr size_t maxSearchPayload = 1400;
 
+/* Limits on the rate of search datagrams (each sent to every search destination).
+ * Adjusted between these bounds according to the fraction of names searched
+ * which are answered, measured over searchAdaptInterval.
+ */
+constexpr double searchRateInitial = 1000.0; // datagrams per second
+constexpr double searchRateMin = 50.0;
+constexpr double searchRateMax = 20000.0;
+constexpr double searchAdaptInterval = 0.25; // seconds
+
 /* Interval between checks for Channels which are no longer used by any operation.
  * Channels will be discarded if found to be unused by two consecutive checks.
  */
@@ -464,6 +473,22 @@ Report Context::report(bool zero) const
     Report ret;
 
     pvt->impl->tcp_loop.call([this, &ret, zero](){
+        auto& impl = *pvt->impl;
+
+        for(auto i : range(impl.initialSearchNext, impl.initialSearchBucket.size())) {
+            auto chan = impl.initialSearchBucket[i].lock();
+            if(chan && chan->state==Channel::Searching)
+                ret.search.pending++;
+        }
+        for(auto& pair : impl.chanByCID) {
+            auto chan = pair.second.lock();
+            if(chan && chan->state==Channel::Searching)
+                ret.search.inFlight++;
+        }
+        ret.search.inFlight -= ret.search.pending;
+        ret.search.resolved = impl.searchResolved;
+        ret.search.resolvedRate = impl.searchResolvedRate;
+        ret.search.rate = impl.searchRate;
 
         for(auto& pair : pvt->impl->connByAddr) {
             auto conn = pair.second.lock();
@@ -475,9 +500,13 @@ Report Context::report(bool zero) const
             sconn.peer = conn->peerName;
             sconn.tx = conn->statTx;
             sconn.rx = conn->statRx;
+            sconn.txMsgs = conn->statTxMsg;
+            sconn.txWrites = conn->statTxWrite;
+            conn->statTxLatency.summarize(sconn.encodeToWrite, zero);
 
             if(zero) {
                 conn->statTx = conn->statRx = 0u;
+                conn->statTxMsg = conn->statTxWrite = 0u;
             }
 
             // omit stats for transitory conn->creatingByCID
@@ -543,6 +572,8 @@ ContextImpl::ContextImpl(const Config& conf, const evbase& tcp_loop)
                event_new(tcp_loop.base, -1, EV_TIMEOUT|EV_PERSIST, &ContextImpl::onNSCheckS, this))
 {
     searchBuckets.resize(nBuckets);
+    searchRate = searchRateInitial;
+    searchRefill = searchWindowStart = searchResolvedTime = epicsMonotonicGet();
 
     std::set<SockAddr, SockAddrOnlyLess> bcasts;
     for(auto& addr : searchTx4.broadcasts()) {
@@ -898,6 +929,9 @@ void procSearchReply(ContextImpl& self, const SockAddr& src, uint8_t peerVersion
         log_debug_printf(io, "Search reply for %s\n", chan->name.c_str());
 
         if(chan->state==Channel::Searching) {
+            self.searchResolved++;
+            self.searchWindowRx++;
+
             chan->guid = guid;
             chan->replyAddr = serv;
 
@@ -1008,6 +1042,33 @@ void ContextImpl::onSearchS(evutil_socket_t fd, short evt, void *raw)
     }
 }
 
+void ContextImpl::adaptSearchRate(epicsUInt64 now)
+{
+    auto age = (now - searchWindowStart)*1e-9;
+    if(age < searchAdaptInterval)
+        return;
+
+    if(searchWindowTx) {
+        auto ratio = double(searchWindowRx)/searchWindowTx;
+
+        // Servers do not reply to names they do not claim, so the absence of
+        // replies may only mean that the PVs do not exist.  Treat a window
+        // without any reply, or a sharp drop of the reply ratio, as (likely) loss.
+        if(!searchWindowRx || ratio < searchReplyRatio/2.0) {
+            searchRate = std::max(searchRateMin, searchRate/2.0);
+        } else {
+            searchRate = std::min(searchRateMax, searchRate*1.25);
+        }
+        searchReplyRatio = 0.75*searchReplyRatio + 0.25*ratio;
+
+        log_debug_printf(io, "Search adapt tx=%zu rx=%zu rate=%.0f\n",
+                         searchWindowTx, searchWindowRx, searchRate);
+    }
+
+    searchWindowStart = now;
+    searchWindowTx = searchWindowRx = 0u;
+}
+
 void ContextImpl::tickSearch(SearchKind kind, bool poked)
 {
     // If kind == SearchKind::discover, then this is a discovery ping.
@@ -1024,15 +1085,33 @@ void ContextImpl::tickSearch(SearchKind kind, bool poked)
 
     log_debug_printf(io, "Search tick %zu\n", idx);
 
-    decltype (searchBuckets)::value_type bucket;
+    // source of Channels to search for, and position of the next to consider.
+    decltype (searchBuckets)::value_type checkBucket;
+    decltype (searchBuckets)::value_type* bucket = &checkBucket;
+    size_t checkPos = 0u;
+    size_t* pos = &checkPos;
     if (kind == SearchKind::initial) {
-        initialSearchBucket.swap(bucket);
+        bucket = &initialSearchBucket;
+        pos = &initialSearchNext;
     } else if(kind == SearchKind::check) {
-        searchBuckets[idx].swap(bucket);
+        searchBuckets[idx].swap(checkBucket);
     }
 
-    while(!bucket.empty() || kind == SearchKind::discover) {
+    if(kind != SearchKind::discover) {
+        auto now(epicsMonotonicGet());
+        adaptSearchRate(now);
+
+        // refill, allowing at most one second of burst
+        searchTokens = std::min(searchRate,
+                                searchTokens + searchRate*(now - searchRefill)*1e-9);
+        searchRefill = now;
+    }
+
+    // always send at least one datagram per tick.  When rate limited, may go into debt.
+    bool first = true;
+    while((*pos < bucket->size() && (first || searchTokens >= 1.0)) || kind == SearchKind::discover) {
         // when 'discover' we only loop once
+        first = false;
 
         searchMsg.resize(0x10000);
         FixedBuf M(true, searchMsg.data(), searchMsg.size());
@@ -1072,12 +1151,13 @@ void ContextImpl::tickSearch(SearchKind kind, bool poked)
         M.skip(2u, __FILE__, __LINE__);
 
         bool payload = false;
-        while(!bucket.empty()) {
+        while(*pos < bucket->size()) {
             assert(kind != SearchKind::discover);
 
-            auto chan = bucket.front().lock();
+            auto& ent = (*bucket)[*pos];
+            auto chan = ent.lock();
             if(!chan || chan->state!=Channel::Searching) {
-                bucket.pop_front();
+                (*pos)++;
                 continue;
             }
 
@@ -1089,7 +1169,7 @@ void ContextImpl::tickSearch(SearchKind kind, bool poked)
                 // some absurdly long PV name?
                 log_err_printf(io, "PV name exceeds search buffer: '%s'\n", chan->name.c_str());
                 // drop it on the floor
-                bucket.pop_front();
+                (*pos)++;
                 continue;
 
             } else if(size_t(M.save() - searchMsg.data()) > maxSearchPayload) {
@@ -1123,11 +1203,8 @@ void ContextImpl::tickSearch(SearchKind kind, bool poked)
                     next = nextnext;
             }
 
-            auto& nextBucket = searchBuckets[next];
-
-            nextBucket.splice(nextBucket.end(),
-                              bucket,
-                              bucket.begin());
+            searchBuckets[next].push_back(std::move(ent));
+            (*pos)++;
             payload = true;
         }
         assert(M.good());
@@ -1135,6 +1212,11 @@ void ContextImpl::tickSearch(SearchKind kind, bool poked)
         if(!payload && kind != SearchKind::discover)
             break;
 
+        if(kind != SearchKind::discover) {
+            searchTokens -= 1.0;
+            searchWindowTx += count;
+        }
+
         {
             FixedBuf C(true, pcount, 2u);
             to_wire(C, count);
@@ -1144,17 +1226,48 @@ void ContextImpl::tickSearch(SearchKind kind, bool poked)
             FixedBuf H(true, searchMsg.data(), 8);
             to_wire(H, Header{CMD_SEARCH, 0, uint32_t(consumed-8u)});
         }
-        for(auto& pair : searchDest) {
-            auto& dest = pair.first.addr.family()==AF_INET ? searchTx4 : searchTx6;
+        // unicast destinations get an identical message, so are sent in batches.
+        *pflags |= pva_search_flags::Unicast;
+        for(auto af : {AF_INET, AF_INET6}) {
+            auto& dest = af==AF_INET ? searchTx4 : searchTx6;
+
+            searchBatch.clear();
+            for(auto& pair : searchDest) {
+                if(pair.second && pair.first.addr.family()==af)
+                    searchBatch.push_back(&pair.first.addr);
+            }
 
-            if(pair.second) {
-                *pflags |= pva_search_flags::Unicast;
+            for(size_t i=0u; i<searchBatch.size(); ) {
+                auto nsent = sendtoMany(dest.sock, searchMsg.data(), consumed,
+                                        searchBatch.data()+i, searchBatch.size()-i);
+                for(auto n : range(i, i+nsent)) {
+                    log_hex_printf(io, Level::Debug, (char*)searchMsg.data(), consumed,
+                                   "Search to %s ucast\n",
+                                   searchBatch[n]->tostring().c_str());
+                }
+                i += nsent;
+
+                if(i<searchBatch.size()) {
+                    int err = evutil_socket_geterror(dest.sock);
+                    auto lvl = Level::Warn;
+                    if(err==EINTR || err==EPERM)
+                        lvl = Level::Debug;
+                    log_printf(io, lvl, "Search tx %s error (%d) %s\n",
+                               searchBatch[i]->tostring().c_str(), err, evutil_socket_error_to_string(err));
+                    i++; // skip failed destination
+                }
+            }
+        }
 
-            } else {
-                *pflags &= ~pva_search_flags::Unicast;
+        // broadcast and multicast destinations.  one at a time as socket options may differ
+        *pflags &= ~pva_search_flags::Unicast;
+        for(auto& pair : searchDest) {
+            if(pair.second)
+                continue;
 
-                dest.mcast_prep_sendto(pair.first);
-            }
+            auto& dest = pair.first.addr.family()==AF_INET ? searchTx4 : searchTx6;
+
+            dest.mcast_prep_sendto(pair.first);
 
             int ntx = sendto(dest.sock, (char*)searchMsg.data(), consumed, 0,
                              &pair.first.addr->sa, pair.first.addr.size());
@@ -1175,7 +1288,7 @@ void ContextImpl::tickSearch(SearchKind kind, bool poked)
                 log_hex_printf(io, Level::Debug, (char*)searchMsg.data(), consumed,
                                "Search to %s %s\n",
                                std::string(SB()<<pair.first).c_str(),
-                               pair.second ? "ucast" : "bcast");
+                               "bcast");
             }
         }
         *pflags |= 0x80; // TCP search is always "unicast"
@@ -1203,6 +1316,23 @@ void ContextImpl::tickSearch(SearchKind kind, bool poked)
         if(kind == SearchKind::discover)
             break;
     }
+
+    if(kind == SearchKind::initial) {
+        if(initialSearchNext < initialSearchBucket.size()) {
+            // rate limited.  continue after a short delay.
+            scheduleInitialSearch();
+        } else {
+            initialSearchBucket.clear();
+            initialSearchNext = 0u;
+        }
+
+    } else if(kind == SearchKind::check && checkPos < checkBucket.size()) {
+        // rate limited.  defer the remainder to the next tick
+        auto& nextBucket = searchBuckets[currentBucket];
+        nextBucket.insert(nextBucket.end(),
+                          std::make_move_iterator(checkBucket.begin()+checkPos),
+                          std::make_move_iterator(checkBucket.end()));
+    }
 }
 
 void ContextImpl::tickSearchS(evutil_socket_t fd, short evt, void *raw)
@@ -1220,6 +1350,16 @@ void ContextImpl::tickSearchS(evutil_socket_t fd, short evt, void *raw)
 
         self->tickSearch(SearchKind::check, poke);
 
+        {
+            auto now(epicsMonotonicGet());
+            auto age = (now - self->searchResolvedTime)*1e-9;
+            if(age >= 1.0) {
+                self->searchResolvedRate = (self->searchResolved - self->searchResolvedPrev)/age;
+                self->searchResolvedPrev = self->searchResolved;
+                self->searchResolvedTime = now;
+            }
+        }
+
         if(event_add(self->searchTimer.get(), poke ? &bucketIntervalFast : &bucketInterval))
             log_err_printf(setup, "Error re-enabling search timer on\n%s", "");
 
@@ -77,6 +77,7 @@ struct RequestInfo {
 
     Value prototype;
     std::shared_ptr<RequestFL> fl;
+    std::shared_ptr<ArrayPool> arrays;
 
     RequestInfo(uint32_t sid, uint32_t ioid, std::shared_ptr<OperationBase>& handle);
 };
@@ -289,12 +290,30 @@ struct ContextImpl : public std::enable_shared_from_this<ContextImpl>
 
     // search destination address and whether to set the unicast flag
     std::vector<std::pair<SockEndpoint, bool>> searchDest;
+    // scratch list of unicast destinations during tickSearch()
+    std::vector<const SockAddr*> searchBatch;
 
     size_t currentBucket = 0u;
-    // Channels where we have yet to send out an initial search request
-    std::list<std::weak_ptr<Channel>> initialSearchBucket;
+    // Channels where we have yet to send out an initial search request.
+    // Entries before initialSearchNext have already been sent.
+    std::vector<std::weak_ptr<Channel>> initialSearchBucket;
+    size_t initialSearchNext = 0u;
     // Channels where we are waiting for a search response
-    std::vector<std::list<std::weak_ptr<Channel>>> searchBuckets;
+    std::vector<std::vector<std::weak_ptr<Channel>>> searchBuckets;
+
+    // search datagram rate limit.  token bucket refilled at searchRate (datagrams per second)
+    double searchRate;
+    double searchTokens = 0.0;
+    epicsUInt64 searchRefill; // epicsMonotonicGet()
+    // names sent, and positive replies received, during the current adaptation window
+    epicsUInt64 searchWindowStart;
+    size_t searchWindowTx = 0u, searchWindowRx = 0u;
+    // moving average of the reply ratio for previous windows
+    double searchReplyRatio = 0.0;
+    // total positive search replies, and the rate estimated by tickSearchS()
+    size_t searchResolved = 0u, searchResolvedPrev = 0u;
+    epicsUInt64 searchResolvedTime;
+    double searchResolvedRate = 0.0;
 
     std::list<std::unique_ptr<UDPListener> > beaconRx;
 
@@ -344,6 +363,7 @@ struct ContextImpl : public std::enable_shared_from_this<ContextImpl>
     static void onSearchS(evutil_socket_t fd, short evt, void *raw);
     enum class SearchKind { discover, initial, check };
     void tickSearch(SearchKind kind, bool poked);
+    void adaptSearchRate(epicsUInt64 now);
     static void tickSearchS(evutil_socket_t fd, short evt, void *raw);
     static void initialSearchS(evutil_socket_t fd, short evt, void *raw);
     void tickBeaconClean();
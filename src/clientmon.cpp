@@ -69,6 +69,8 @@ struct SubscriptionImpl final : public OperationBase, public Subscription
     size_t nSrvSquash =0u;
     size_t nCliSquash =0u;
     size_t queueMax =0u;
+    // recycles storage of received arrays.  set on INIT
+    std::shared_ptr<ArrayPool> arrays;
     // user code has seen pop()==nullptr
     bool needNotify = true;
     bool ackPending = false; // ackTick scheduled
@@ -151,6 +153,8 @@ struct SubscriptionImpl final : public OperationBase, public Subscription
         ret.nSrvSquash = nSrvSquash;
         ret.nCliSquash = nCliSquash;
         ret.nQueue = queue.size();
+        if(arrays)
+            arrays->stats(ret.nArrayReuse, ret.nArrayAlloc, reset);
         if(reset) {
             nSrvSquash = nCliSquash = queueMax = 0u;
         }
@@ -545,7 +549,9 @@ void Connection::handle_MONITOR()
 
                 Value::Helper::set_desc(data, desc);
             }
+            M.arrayPool = info->arrays.get();
             from_wire_valid(M, rxRegistry, data);
+            M.arrayPool = nullptr;
 
             cache_sync(info->prototype, data);
 
@@ -659,6 +665,8 @@ void Connection::handle_MONITOR()
              * accumulate another.
              */
             info->fl = std::make_shared<RequestFL>(2u*mon->queueSize);
+            // arrays of updates in both of those queues, plus those being decoded
+            info->arrays = mon->arrays = std::make_shared<ArrayPool>(2u*mon->queueSize + 2u);
 
         } else {
 
@@ -739,30 +747,32 @@ void Connection::handle_MONITOR()
 
 
 std::shared_ptr<Subscription> MonitorBuilder::exec()
+{
+    return execMany({_name}).front();
+}
+
+std::vector<std::shared_ptr<Subscription>>
+MonitorBuilder::execMany(const std::vector<std::string>& names)
 {
     if(!ctx)
         throw std::logic_error("NULL Builder");
 
     auto context(ctx->impl->shared_from_this());
 
-    auto op(std::make_shared<SubscriptionImpl>(context->tcp_loop));
-    op->self = op;
-    op->channelName = std::move(_name);
-    op->event = std::move(_event);
-    op->onInit = std::move(_onInit);
-    op->pvRequest = _buildReq();
-    op->maskConn = _maskConn;
-    op->maskDiscon = _maskDisconn;
-    op->autostart = _autoexec;
+    // pvRequest and options are common to all
+    auto pvRequest(_buildReq());
+    uint32_t queueSize = 4u; // default of SubscriptionImpl::queueSize
+    bool pipeline = false;
+    uint32_t ackAt = 0u;
 
-    auto options = op->pvRequest["record._options"];
+    auto options = pvRequest["record._options"];
 
-    options["queueSize"].as<uint32_t>([&op](uint32_t Q) {
+    options["queueSize"].as<uint32_t>([&queueSize](uint32_t Q) {
         if(Q>1)
-            op->queueSize = Q;
+            queueSize = Q;
     });
 
-    (void)options["pipeline"].as(op->pipeline);
+    (void)options["pipeline"].as(pipeline);
 
     auto ackAny = options["ackAny"];
 
@@ -772,7 +782,7 @@ std::shared_ptr<Subscription> MonitorBuilder::exec()
             try {
                 auto percent = parseTo<double>(sval.substr(0, sval.size()-1u));
                 if(percent>0.0 && percent<=100.0) {
-                    op->ackAt = uint32_t(percent * op->queueSize);
+                    ackAt = uint32_t(percent * queueSize);
                 } else {
                     throw std::invalid_argument("not in range (0%, 100%]");
                 }
@@ -783,55 +793,81 @@ std::shared_ptr<Subscription> MonitorBuilder::exec()
 
     }
 
-    if(op->ackAt==0u){
+    if(ackAt==0u){
         uint32_t count=0u;
 
         if(ackAny.as(count)) {
-            op->ackAt = count;
+            ackAt = count;
         }
     }
 
-    if(op->ackAt==0u){
-        op->ackAt = op->queueSize/2u;
+    if(ackAt==0u){
+        ackAt = queueSize/2u;
     }
 
-    op->ackAt = std::max(1u, std::min(op->ackAt, op->queueSize));
-
-    auto syncCancel(_syncCancel);
-    std::shared_ptr<SubscriptionImpl> external(op.get(), [op, syncCancel](SubscriptionImpl*) mutable {
-        // from user thread
-        auto temp(std::move(op));
-        auto loop(temp->loop);
-        // std::bind for lack of c++14 generalized capture
-        // to move internal ref to worker for dtor
-        loop.tryInvoke(syncCancel, std::bind([](std::shared_ptr<SubscriptionImpl>& op) {
-                           // on worker
-
-                           // ordering of dispatch()/call() ensures creation before destruction
-                           if(op->chan)
-                               op->_cancel(true);
-                       }, std::move(temp)));
-    });
+    ackAt = std::max(1u, std::min(ackAt, queueSize));
+
+    std::vector<std::shared_ptr<SubscriptionImpl>> ops;
+    std::vector<std::shared_ptr<Subscription>> ret;
+    ops.reserve(names.size());
+    ret.reserve(names.size());
+
+    for(auto& name : names) {
+        auto op(std::make_shared<SubscriptionImpl>(context->tcp_loop));
+        op->self = op;
+        op->channelName = name;
+        op->event = _event;
+        op->onInit = _onInit;
+        op->pvRequest = pvRequest;
+        op->maskConn = _maskConn;
+        op->maskDiscon = _maskDisconn;
+        op->autostart = _autoexec;
+        op->queueSize = queueSize;
+        op->pipeline = pipeline;
+        op->ackAt = ackAt;
+
+        auto syncCancel(_syncCancel);
+        std::shared_ptr<SubscriptionImpl> external(op.get(), [op, syncCancel](SubscriptionImpl*) mutable {
+            // from user thread
+            auto temp(std::move(op));
+            auto loop(temp->loop);
+            // std::bind for lack of c++14 generalized capture
+            // to move internal ref to worker for dtor
+            loop.tryInvoke(syncCancel, std::bind([](std::shared_ptr<SubscriptionImpl>& op) {
+                               // on worker
+
+                               // ordering of dispatch()/call() ensures creation before destruction
+                               if(op->chan)
+                                   op->_cancel(true);
+                           }, std::move(temp)));
+        });
 
-    auto server(std::move(_server));
-    context->tcp_loop.dispatch([op, context, server]() {
+        ops.push_back(std::move(op));
+        ret.push_back(std::move(external));
+    }
+
+    // one visit to the worker to create all
+    auto server(_server);
+    context->tcp_loop.dispatch(std::bind([context, server](std::vector<std::shared_ptr<SubscriptionImpl>>& ops) {
         // on worker
 
-        try {
-            op->chan = Channel::build(context, op->channelName, server);
-
-            op->chan->pending.push_back(op);
-            op->chan->createOperations();
-        }catch(...){
-            // nothing else has happened, so the queue will be empty
-            assert(op->queue.empty());
-            op->queue.emplace_back();
-            op->queue.back().exc = std::current_exception();
-            op->doNotify();
+        for(auto& op : ops) {
+            try {
+                op->chan = Channel::build(context, op->channelName, server);
+
+                op->chan->pending.push_back(op);
+                op->chan->createOperations();
+            }catch(...){
+                // nothing else has happened, so the queue will be empty
+                assert(op->queue.empty());
+                op->queue.emplace_back();
+                op->queue.back().exc = std::current_exception();
+                op->doNotify();
+            }
         }
-    });
+    }, std::move(ops)));
 
-    return external;
+    return ret;
 }
 
 } // namespace client
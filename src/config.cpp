@@ -433,6 +433,34 @@ void _fromDefs(Config& self, const std::map<std::string, std::string>& defs, boo
     if(pickone({"EPICS_PVA_CONN_TMO"})) {
         parse_timeout(self.tcpTimeout, pickone.name, pickone.val);
     }
+
+    if(pickone({"EPICS_PVAS_TCP_WORKERS"})) {
+        try {
+            self.tcpWorkers = parseTo<uint64_t>(pickone.val);
+        }catch(std::exception& e) {
+            log_err_printf(serversetup, "%s invalid integer : %s", pickone.name.c_str(), e.what());
+        }
+    }
+
+    if(pickone({"EPICS_PVAS_HANDLER_WORKERS"})) {
+        try {
+            self.handlerWorkers = parseTo<uint64_t>(pickone.val);
+        }catch(std::exception& e) {
+            log_err_printf(serversetup, "%s invalid integer : %s", pickone.name.c_str(), e.what());
+        }
+    }
+
+    if(pickone({"EPICS_PVAS_MEMORY_BUDGET"})) {
+        try {
+            self.memoryBudget = parseTo<uint64_t>(pickone.val);
+        }catch(std::exception& e) {
+            log_err_printf(serversetup, "%s invalid integer : %s", pickone.name.c_str(), e.what());
+        }
+    }
+
+    if(pickone({"EPICS_PVAS_MEMORY_BUDGET_DISCONNECT"})) {
+        parse_bool(self.memoryBudgetDisconnect, pickone.name, pickone.val);
+    }
 }
 
 Config& Config::applyEnv()
@@ -479,6 +507,10 @@ void Config::updateDefs(defs_t& defs) const
     defs["EPICS_PVA_INTF_ADDR_LIST"] = defs["EPICS_PVAS_INTF_ADDR_LIST"]   = join_addr(interfaces);
     defs["EPICS_PVAS_IGNORE_ADDR_LIST"]   = join_addr(ignoreAddrs);
     defs["EPICS_PVA_CONN_TMO"] = SB()<<tcpTimeout/tmoScale;
+    defs["EPICS_PVAS_TCP_WORKERS"] = SB()<<tcpWorkers;
+    defs["EPICS_PVAS_HANDLER_WORKERS"] = SB()<<handlerWorkers;
+    defs["EPICS_PVAS_MEMORY_BUDGET"] = SB()<<memoryBudget;
+    defs["EPICS_PVAS_MEMORY_BUDGET_DISCONNECT"] = memoryBudgetDisconnect ? "YES" : "NO";
 }
 
 void Config::expand()
@@ -525,6 +557,10 @@ void Config::expand()
 
     enforceTimeout(tcpTimeout);
 
+    if(tcpWorkers==0u) {
+        auto ncpu = epicsThreadGetCPUs();
+        tcpWorkers = ncpu>0 ? unsigned(ncpu) : 1u;
+    }
 }
 
 std::ostream& operator<<(std::ostream& strm, const Config& conf)
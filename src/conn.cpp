@@ -5,6 +5,7 @@
  */
 
 #include <limits>
+#include <algorithm>
 
 #include <epicsAssert.h>
 
@@ -26,6 +27,76 @@ namespace impl {
 static
 constexpr size_t tcp_readahead_mult = 2u;
 
+void LatencyHist::record(uint64_t ns)
+{
+    size_t idx = 0u;
+    if(ns >= (uint64_t(1u)<<minShift)) {
+#ifdef __GNUC__
+        unsigned msb = 63u - unsigned(__builtin_clzll(ns));
+#else
+        unsigned msb = 0u;
+        for(auto v = ns>>1u; v; v>>=1u)
+            msb++;
+#endif
+        auto octave = msb - minShift;
+        if(octave >= nOctave) {
+            idx = nBuckets-1u;
+        } else {
+            auto sub = (ns >> (msb-subBits)) & ((1u<<subBits)-1u);
+            idx = 1u + (size_t(octave)<<subBits) + sub;
+        }
+    }
+    counts[idx]++;
+    count++;
+    if(maxns < ns)
+        maxns = ns;
+}
+
+uint64_t LatencyHist::quantile(double p) const
+{
+    if(!count)
+        return 0u;
+
+    auto target = uint64_t(p*count + 0.5);
+    if(target < 1u)
+        target = 1u;
+
+    uint64_t accum = 0u;
+    for(size_t idx=0u; idx<nBuckets; idx++) {
+        accum += counts[idx];
+        if(accum < target)
+            continue;
+
+        uint64_t upper = uint64_t(1u)<<minShift;
+        if(idx) {
+            auto octave = (idx-1u)>>subBits;
+            auto sub = (idx-1u)&((1u<<subBits)-1u);
+            auto msb = octave + minShift;
+            upper = (uint64_t(1u)<<msb) + (uint64_t(sub+1u)<<(msb-subBits));
+        }
+        return std::min(upper, maxns);
+    }
+    return maxns;
+}
+
+void LatencyHist::reset()
+{
+    for(auto& cnt : counts)
+        cnt = 0u;
+    count = maxns = 0u;
+}
+
+void LatencyHist::summarize(Report::Latency& out, bool zero)
+{
+    out.count = count;
+    out.p50 = quantile(0.50)*1e-9;
+    out.p99 = quantile(0.99)*1e-9;
+    out.p999 = quantile(0.999)*1e-9;
+    out.max = maxns*1e-9;
+    if(zero)
+        reset();
+}
+
 ConnBase::ConnBase(bool isClient, bool sendBE, bufferevent* bev, const SockAddr& peerAddr)
     :peerAddr(peerAddr)
     ,peerName(peerAddr.tostring())
@@ -45,7 +116,22 @@ ConnBase::ConnBase(bool isClient, bool sendBE, bufferevent* bev, const SockAddr&
     }
 }
 
-ConnBase::~ConnBase() {}
+ConnBase::~ConnBase()
+{
+    bev.reset();
+    releaseTxMemory();
+}
+
+void ConnBase::releaseTxMemory()
+{
+    if(memory) {
+        memory->sub(memoryTx);
+        memory->subShared(memorySharedTx);
+    }
+    memoryTx = memorySharedTx = 0u;
+    txBodyShared = txSharedPending = 0u;
+    txShared.clear();
+}
 
 const char* ConnBase::peerLabel() const
 {
@@ -75,9 +161,16 @@ void ConnBase::connect(ev_owned_ptr<bufferevent> &&bev)
     state = isClient ? Connecting : Connected;
 
     this->bev = std::move(bev);
+    txTimes.clear();
+    txDrained = 0u;
+    releaseTxMemory();
 
     // initially wait for at least a header
     bufferevent_setwatermark(this->bev.get(), EV_READ, 8, readahead);
+
+    // count socket writes, each of which drains the output buffer
+    if(!evbuffer_add_cb(bufferevent_get_output(this->bev.get()), &txDrainS, this))
+        throw BAD_ALLOC();
 }
 
 void ConnBase::disconnect()
@@ -94,12 +187,112 @@ size_t ConnBase::enqueueTxBody(pva_app_msg_t cmd)
                         uint8_t(isClient ? 0u : pva_flags::Server),
                         uint32_t(blen)},
              sendBE);
+    if(memory && txBodyShared) {
+        auto end = txDrained + evbuffer_get_length(tx) + blen;
+        txShared.emplace_back(end - txBodyShared, end);
+        txSharedPending += txBodyShared;
+    }
+    txBodyShared = 0u;
     auto err = evbuffer_add_buffer(tx, txBody.get());
     assert(!err); // could only fail if frozen/pinned, which is not the case
+    txTimes.emplace_back(txDrained + evbuffer_get_length(tx), epicsMonotonicGet());
     statTx += 8u + blen;
+    statTxMsg++;
+    if(txCoalesceTimer)
+        coalesceTx();
     return 8u + blen;
 }
 
+void ConnBase::coalesceTx()
+{
+    auto tx = bufferevent_get_output(bev.get());
+
+    if(evbuffer_get_length(tx) >= txCoalesceBytes) {
+        releaseTx();
+
+    } else if(!txHeld) {
+        timeval tmo(totv(txCoalesceDelay));
+        if(event_add(txCoalesceTimer.get(), &tmo)) {
+            log_err_printf(connio, "%s %s Unable to start TX coalesce timer\n", peerLabel(), peerName.c_str());
+            return;
+        }
+        (void)bufferevent_disable(bev.get(), EV_WRITE);
+        txHeld = true;
+    }
+}
+
+void ConnBase::releaseTx()
+{
+    if(!txHeld)
+        return;
+
+    txHeld = false;
+    (void)event_del(txCoalesceTimer.get());
+    if(bev)
+        (void)bufferevent_enable(bev.get(), EV_WRITE);
+}
+
+void ConnBase::txCoalesceS(evutil_socket_t fd, short evt, void *raw)
+{
+    auto conn = static_cast<ConnBase*>(raw);
+    try {
+        conn->releaseTx();
+    }catch(std::exception& e){
+        log_exc_printf(connsetup, "%s %s Unhandled error in TX coalesce callback: %s\n", conn->peerLabel(), conn->peerName.c_str(), e.what());
+    }
+}
+
+void ConnBase::txDrainS(struct evbuffer *buf, const struct evbuffer_cb_info *info, void *raw)
+{
+    auto self = static_cast<ConnBase*>(raw);
+
+    if(self->memory) {
+        // bytes shared with other connections are charged elsewhere
+        auto shared = std::min(info->n_added, self->txSharedPending);
+        self->txSharedPending -= shared;
+        auto added = info->n_added - shared;
+
+        // shared bytes written, taken to be at the end of each message
+        auto first = self->txDrained, last = self->txDrained + info->n_deleted;
+        size_t sharedDeleted = 0u;
+        while(!self->txShared.empty() && self->txShared.front().first < last) {
+            auto& range = self->txShared.front();
+            auto start = std::max(range.first, first);
+            auto end = std::min(range.second, last);
+            sharedDeleted += end - start;
+            if(range.second > last) {
+                range.first = last;
+                break;
+            }
+            self->txShared.pop_front();
+        }
+        auto deleted = info->n_deleted - sharedDeleted;
+
+        self->memory->add(added);
+        self->memory->sub(deleted);
+        self->memoryTx += added;
+        self->memoryTx -= deleted;
+        self->memory->addShared(shared);
+        self->memory->subShared(sharedDeleted);
+        self->memorySharedTx += shared;
+        self->memorySharedTx -= sharedDeleted;
+    }
+
+    if(!info->n_deleted)
+        return;
+
+    self->statTxWrite++;
+    self->txDrained += info->n_deleted;
+
+    if(!self->txTimes.empty() && self->txTimes.front().first <= self->txDrained) {
+        auto now(epicsMonotonicGet());
+        while(!self->txTimes.empty() && self->txTimes.front().first <= self->txDrained) {
+            self->statTxLatency.record(now - self->txTimes.front().second);
+            self->txTimes.pop_front();
+        }
+    }
+}
+
 #define CASE(Op) void ConnBase::handle_##Op() {}
     CASE(ECHO);
     CASE(CONNECTION_VALIDATION);
@@ -223,7 +416,9 @@ void ConnBase::bevRead()
 
         // so far we do not use segmentation to support incremental processing
         // of long messages.  We instead accumulate all segments of a message
-        // prior to parsing.
+        // prior to parsing.  So peak memory for a large message is the complete
+        // wire body plus the decoded result.  EvInBuf::copyout() only releases
+        // the wire copy of an array progressively as it is decoded.
 
         auto seg = header[2]&pva_flags::SegMask;
 
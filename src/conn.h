@@ -6,6 +6,12 @@
 #ifndef CONN_H
 #define CONN_H
 
+#include <atomic>
+#include <deque>
+
+#include <epicsTime.h>
+
+#include <pvxs/server.h>
 #include "evhelper.h"
 #include "dataimpl.h"
 #include "utilpvt.h"
@@ -13,6 +19,83 @@
 namespace pvxs {
 namespace impl {
 
+/* Log-linear histogram of durations, after HdrHistogram.
+ * Each power of two nanoseconds from 1 us to ~69 sec. is split into
+ * 4 sub-buckets, for a resolution of 25%.  Shorter times are counted
+ * in the first bucket, longer in the last.
+ */
+struct LatencyHist
+{
+    static constexpr unsigned subBits = 2u;
+    static constexpr unsigned minShift = 10u; // 1024 ns
+    static constexpr unsigned nOctave = 26u;
+    static constexpr size_t nBuckets = 1u + (size_t(nOctave)<<subBits);
+
+    uint32_t counts[nBuckets];
+    uint64_t count, maxns;
+
+    LatencyHist() { reset(); }
+
+    void record(uint64_t ns);
+    // upper bound of the bucket containing the 0 <= p <= 1 quantile
+    uint64_t quantile(double p) const;
+    void reset();
+    void summarize(Report::Latency& out, bool zero);
+};
+
+/* Count of bytes held for peers, with a server wide total as parent.
+ * cf. server::Config::memoryBudget
+ */
+struct MemBudget
+{
+    std::atomic<size_t> held{0u};
+    // bytes also referenced, but charged once to the parent elsewhere.  cf. MemCharge
+    std::atomic<size_t> shared{0u};
+    const std::shared_ptr<MemBudget> parent;
+
+    explicit MemBudget(const std::shared_ptr<MemBudget>& parent = nullptr) :parent(parent) {}
+
+    void add(size_t n) {
+        held.fetch_add(n, std::memory_order_relaxed);
+        if(parent)
+            parent->add(n);
+    }
+    void sub(size_t n) {
+        held.fetch_sub(n, std::memory_order_relaxed);
+        if(parent)
+            parent->sub(n);
+    }
+    // not propagated to parent
+    void addShared(size_t n) {
+        shared.fetch_add(n, std::memory_order_relaxed);
+    }
+    void subShared(size_t n) {
+        shared.fetch_sub(n, std::memory_order_relaxed);
+    }
+    // all bytes referenced, whether charged here or elsewhere
+    size_t referenced() const {
+        return held.load(std::memory_order_relaxed) + shared.load(std::memory_order_relaxed);
+    }
+};
+
+/* Bytes charged to a MemBudget while referenced.
+ * For storage shared by several connections, so that it is counted once.
+ */
+struct MemCharge
+{
+    const std::shared_ptr<MemBudget> budget;
+    const size_t nbytes;
+
+    MemCharge(const std::shared_ptr<MemBudget>& budget, size_t nbytes) :budget(budget), nbytes(nbytes) {
+        budget->add(nbytes);
+    }
+    ~MemCharge() {
+        budget->sub(nbytes);
+    }
+    MemCharge(const MemCharge&) = delete;
+    MemCharge& operator=(const MemCharge&) = delete;
+};
+
 struct ConnBase
 {
     const SockAddr peerAddr;
@@ -21,6 +104,7 @@ protected:
     evbufferevent bev;
 public:
     TypeStore rxRegistry;
+    TypeTxCache txRegistry;
     /* Flag if some received delta could not be decoded due to
      * a non-existent IOID, which *may* leave this rxRegistry out
      * of sync with the peer (if it contains Variant Unions).
@@ -41,8 +125,38 @@ public:
     evbuf segBuf, txBody;
 
     size_t statTx{}, statRx{};
+    // number of messages queued, and of socket writes which sent them
+    size_t statTxMsg{}, statTxWrite{};
+    // time from queueing a message until the socket write which completes it
+    LatencyHist statTxLatency;
+    // (offset of message end, time queued) for messages not yet written.
+    // offsets counted from bytes drained since connect()
+    std::deque<std::pair<size_t, epicsUInt64>> txTimes;
+    size_t txDrained{};
+    // when set, account for bytes in TX buffer
+    std::shared_ptr<MemBudget> memory;
+    size_t memoryTx{};
+    // bytes of txBody which reference storage shared with other connections,
+    // and charged once elsewhere.  Counted in memory->shared.  cf. MemCharge
+    size_t txBodyShared{};
+    // shared bytes in TX buffer counted in memory->shared
+    size_t memorySharedTx{};
+    // shared bytes added to TX buffer, but not yet seen by txDrainS()
+    size_t txSharedPending{};
+    // (offset of start, offset of end) of shared bytes not yet written.
+    // Taken to be at the end of each message.  Offsets as for txTimes.
+    std::deque<std::pair<size_t, size_t>> txShared;
     size_t readahead{};
 
+    /* TX coalescing.  When txCoalesceTimer is set, sending is held back
+     * for up to txCoalesceDelay seconds after a message is queued,
+     * or until txCoalesceBytes are queued.
+     */
+    double txCoalesceDelay = 0.0;
+    size_t txCoalesceBytes = 0u;
+    evevent txCoalesceTimer;
+    bool txHeld = false;
+
     enum {
         Holdoff,
         Connecting,
@@ -64,6 +178,12 @@ public:
     void connect(ev_owned_ptr<bufferevent>&& bev);
     void disconnect();
 
+    // begin sending anything held back by TX coalescing
+    void releaseTx();
+
+    // forget TX buffer bytes counted in memory
+    void releaseTxMemory();
+
 protected:
 #define CASE(Op) virtual void handle_##Op();
     CASE(ECHO);
@@ -96,6 +216,9 @@ protected:
     static void bevEventS(struct bufferevent *bev, short events, void *ptr);
     static void bevReadS(struct bufferevent *bev, void *ptr);
     static void bevWriteS(struct bufferevent *bev, void *ptr);
+    void coalesceTx();
+    static void txCoalesceS(evutil_socket_t fd, short evt, void *raw);
+    static void txDrainS(struct evbuffer *buf, const struct evbuffer_cb_info *info, void *raw);
 };
 
 } // namespace impl
@@ -4,6 +4,7 @@
  * in file LICENSE that is included with this distribution.
  */
 
+#include <algorithm>
 #include <cstring>
 #include <epicsAssert.h>
 
@@ -28,6 +29,53 @@ LookupError::LookupError(const std::string& msg)
 
 LookupError::~LookupError() {}
 
+namespace impl {
+
+// FNV-1a
+static inline
+size_t hashName(const char* name, size_t len)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for(auto i : range(len)) {
+        hash ^= uint8_t(name[i]);
+        hash *= 0x100000001b3ull;
+    }
+    return size_t(hash);
+}
+
+void FieldDesc::buildIndex()
+{
+    mindex.clear();
+    mindex.reserve(mlookup.size());
+    for(auto& pair : mlookup) {
+        mindex.push_back(IndexEntry{hashName(pair.first.data(), pair.first.size()), pair.second, pair.first});
+    }
+    std::stable_sort(mindex.begin(), mindex.end(), [](const IndexEntry& lhs, const IndexEntry& rhs) {
+        return lhs.hash < rhs.hash;
+    });
+}
+
+const size_t* FieldDesc::find(const char* name, size_t len) const
+{
+    if(mindex.size()!=mlookup.size()) {
+        // not built (yet)
+        auto it(mlookup.find(std::string(name, len)));
+        return it!=mlookup.end() ? &it->second : nullptr;
+    }
+
+    auto hash(hashName(name, len));
+    auto it(std::lower_bound(mindex.begin(), mindex.end(), hash, [](const IndexEntry& ent, size_t hash) {
+        return ent.hash < hash;
+    }));
+    for(; it!=mindex.end() && it->hash==hash; ++it) {
+        if(it->name.size()==len && memcmp(it->name.data(), name, len)==0)
+            return &it->index;
+    }
+    return nullptr;
+}
+
+} // namespace impl
+
 
 std::shared_ptr<const impl::FieldDesc>
 Value::Helper::type(const Value& v)
@@ -731,7 +779,38 @@ void Value::copyIn(const void *ptr, StoreType type)
     case StoreType::Null:
         if(type==StoreType::Compound) {
             auto& src = *reinterpret_cast<const Value*>(ptr);
-            if(src.type()==TypeCode::Struct) {
+            if(src.type()==TypeCode::Struct && src.desc==desc) {
+                // copy struct to struct of identical type.  eg. during Value::clone()
+                // visit marked fields by offset, w/o lookup by name.
+                // all descendants of a marked struct are copied.
+
+                const auto sstore = src.store.get();
+                const size_t N = desc->size();
+                // copy unconditionally while i < copyAll
+                size_t copyAll = sstore[0].valid ? N : 0u;
+                for(size_t i=1u; i<N; i++) {
+                    if(i>=copyAll && !sstore[i].valid)
+                        continue;
+
+                    Value dfld;
+                    dfld.store = decltype(store)(store, store.get()+i);
+                    dfld.desc = desc+i;
+
+                    if(desc[i].code==TypeCode::Struct) {
+                        // entire sub-struct marked.
+                        dfld.mark();
+                        if(sstore[i].valid)
+                            copyAll = std::max(copyAll, i + desc[i].size());
+                    } else {
+                        dfld.copyIn(&sstore[i].store, sstore[i].code);
+                    }
+                }
+                if(src.isMarked())
+                    mark();
+
+                return;
+
+            } else if(src.type()==TypeCode::Struct) {
                 // copy struct to struct
                 // all marked source field may be mapped to destination fields
 
@@ -825,15 +904,14 @@ void Value::traverse(const std::string &expr, bool modify, bool dothrow)
             }
 
             size_t sep = expr.find_first_of("<[-", pos);
+            size_t len = std::min(sep, expr.size()) - pos;
 
-            decltype (desc->mlookup)::const_iterator it;
-
-            const auto& name = expr.substr(pos, sep-pos);
+            const size_t* it;
 
-            if(sep>0 && (it=desc->mlookup.find(name))!=desc->mlookup.end()) {
+            if(sep>0 && (it=desc->find(expr.data()+pos, len))) {
                 // found it
-                auto next = desc+it->second;
-                decltype(store) value(store, store.get()+it->second);
+                auto next = desc+*it;
+                decltype(store) value(store, store.get()+*it);
                 store = std::move(value);
                 desc = next;
                 pos = sep;
@@ -843,6 +921,7 @@ void Value::traverse(const std::string &expr, bool modify, bool dothrow)
                 store.reset();
                 desc = nullptr;
                 if(dothrow) {
+                    const auto name(expr.substr(pos, len));
                     SB msg;
                     msg<<"no such member field '"<<name<<"'";
                     if(name!=expr)
@@ -868,17 +947,17 @@ void Value::traverse(const std::string &expr, bool modify, bool dothrow)
                     // select member of Union
                     size_t sep = expr.find_first_of("<[-.", pos);
 
-                    decltype (desc->mlookup)::const_iterator it;
+                    const size_t* it;
                     auto& fld = store->as<Value>();
 
-                    if(sep>0 && (it=desc->mlookup.find(expr.substr(pos, sep-pos)))!=desc->mlookup.end()) {
+                    if(sep>0 && (it=desc->find(expr.data()+pos, std::min(sep, expr.size()) - pos))) {
                         // found it.
 
-                        if(modify || fld.desc==&desc->members[it->second]) {
+                        if(modify || fld.desc==&desc->members[*it]) {
                             // will select, or already selected
-                            if(fld.desc!=&desc->members[it->second]) {
+                            if(fld.desc!=&desc->members[*it]) {
                                 // select
-                                std::shared_ptr<const FieldDesc> mtype(store->top->desc, &desc->members[it->second]);
+                                std::shared_ptr<const FieldDesc> mtype(store->top->desc, &desc->members[*it]);
                                 fld = Value(mtype, *this);
                             }
                             pos = sep;
@@ -990,6 +1069,52 @@ const Value Value::lookup(const std::string& name) const
     return ret;
 }
 
+FieldHandle Value::handle(const std::string& name) const
+{
+    if(!desc)
+        throw NoField();
+
+    Value fld(*this);
+    fld.traverse(name, false, true);
+
+    if(fld.store->top!=store->top || fld.desc < desc || fld.desc >= desc+desc->size())
+        throw LookupError(SB()<<"'"<<name<<"' is not a descendant Struct member");
+
+    FieldHandle ret;
+    ret.base = decltype(ret.base)(store->top->desc, desc);
+    ret._name = name;
+    ret.offset = fld.desc - desc;
+    return ret;
+}
+
+Value Value::operator[](const FieldHandle& fld)
+{
+    if(desc && desc==fld.base.get()) {
+        Value ret;
+        ret.store = decltype(store)(store, store.get()+fld.offset);
+        ret.desc = desc+fld.offset;
+        return ret;
+    } else if(desc && fld.base) {
+        return (*this)[fld._name];
+    } else {
+        return Value();
+    }
+}
+
+const Value Value::operator[](const FieldHandle& fld) const
+{
+    if(desc && desc==fld.base.get()) {
+        Value ret;
+        ret.store = decltype(store)(store, store.get()+fld.offset);
+        ret.desc = desc+fld.offset;
+        return ret;
+    } else if(desc && fld.base) {
+        return (*this)[fld._name];
+    } else {
+        return Value();
+    }
+}
+
 size_t Value::nmembers() const
 {
     switch(desc ? desc->code.code : TypeCode::Null) {
@@ -8,12 +8,15 @@
 #define DATAENCODE_H
 
 #include <cassert>
+#include <cstring>
 
 #include <stdexcept>
 #include <functional>
 #include <ostream>
 #include <list>
 #include <map>
+#include <string>
+#include <algorithm>
 #include <utility>
 #include <type_traits>
 #include <memory>
@@ -66,6 +69,59 @@ void to_wire(Buffer& buf, const FieldDesc* cur)
     }
 }
 
+void to_wire(Buffer& buf, const FieldDesc* cur, TypeTxCache& cache)
+{
+    if(!cur || !cache.limit || cur->code.kind()!=Kind::Compound) {
+        to_wire(buf, cur);
+        return;
+    }
+
+    cache.scratch.resize(std::max(cache.scratch.size(), size_t(256u)));
+    size_t len;
+    {
+        VectorOutBuf S(buf.be, cache.scratch);
+        to_wire(S, cur);
+        if(!S.good()) {
+            buf.fault(__FILE__, __LINE__);
+            return;
+        }
+        len = S.consumed();
+    }
+    // no point in caching anything no larger than a reference
+    if(len > 3u) {
+        std::string key(reinterpret_cast<const char*>(cache.scratch.data()), len);
+
+        auto it(cache.ids.find(key));
+        if(it!=cache.ids.end()) {
+            to_wire(buf, uint8_t(0xfe));
+            to_wire(buf, it->second);
+            cache.nhit++;
+            cache.nsaved += len - 3u;
+            return;
+
+        } else if(cache.ids.size() < cache.limit && cache.ids.size() < 0xffffu) {
+            auto id = uint16_t(cache.ids.size());
+            cache.ids.emplace(std::move(key), id);
+            to_wire(buf, uint8_t(0xfd));
+            to_wire(buf, id);
+        }
+    }
+
+    // append already encoded type
+    auto src = cache.scratch.data();
+    while(len) {
+        if(!buf.ensure(1u)) {
+            buf.fault(__FILE__, __LINE__);
+            return;
+        }
+        auto n = std::min(buf.size(), len);
+        memcpy(buf.save(), src, n);
+        buf._skip(n);
+        src += n;
+        len -= n;
+    }
+}
+
 void from_wire(Buffer& buf, std::vector<FieldDesc>& descs, TypeStore& cache, unsigned depth)
 {
     if(!buf.good() || depth>20) {
@@ -181,6 +237,8 @@ void from_wire(Buffer& buf, std::vector<FieldDesc>& descs, TypeStore& cache, uns
                     }
                 }
             }
+
+            descs[index].buildIndex();
         }
             break;
         default:
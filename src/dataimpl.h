@@ -8,6 +8,8 @@
 
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 #include <pvxs/data.h>
 #include <pvxs/sharedArray.h>
@@ -37,6 +39,7 @@ struct Value::Helper {
 
     static inline                       impl::FieldStorage*  store_ptr(      Value& v) { return v.store.get(); }
     static inline                 const impl::FieldStorage*  store_ptr(const Value& v) { return v.store.get(); }
+    static inline long use_count(const Value& v) { return v.store.use_count(); }
 
     static std::shared_ptr<const impl::FieldDesc> type(const Value& v);
 };
@@ -71,6 +74,14 @@ struct FieldDesc {
     // For Union, offset in members array (one entry will always be zero)
     std::map<std::string, size_t> mlookup;
 
+    // Flat copy of mlookup, sorted by hash of name.  cf. buildIndex() and find()
+    struct IndexEntry {
+        size_t hash;
+        size_t index;
+        std::string name;
+    };
+    std::vector<IndexEntry> mindex;
+
     // child iteration.  child# -> ("sub", rel index in enclosing vector<FieldDesc>)
     std::vector<std::pair<std::string, size_t>> miter;
 
@@ -90,6 +101,11 @@ struct FieldDesc {
 
     // number of FieldDesc nodes which describe this node.  Inclusive.  always size()>=1
     inline size_t size() const { return 1u + (members.empty() ? mlookup.size() : 0u); }
+
+    // populate mindex from mlookup.  Call once all descendants have been added.
+    void buildIndex();
+    // Equivalent to mlookup.find() with [name, name+len) .  Returns nullptr if not found.
+    const size_t* find(const char* name, size_t len) const;
 };
 
 PVXS_API
@@ -97,6 +113,28 @@ void to_wire(Buffer& buf, const FieldDesc* cur);
 
 typedef std::map<uint16_t, std::vector<FieldDesc>> TypeStore;
 
+/* Per-connection record of type descriptions already sent.
+ * A Struct or Union type is sent once with 0xfd and a cache ID,
+ * then by 0xfe and ID only.  Matches by encoded bytes, so identical types
+ * from different TypeDefs share an ID.
+ *
+ * IDs are never re-used as the peer can't be told to forget a type.
+ * Once limit is reached, new types are sent in full.  Zero disables caching.
+ */
+struct PVXS_API TypeTxCache {
+    std::unordered_map<std::string, uint16_t> ids;
+    size_t limit = 0u;
+    // count of 0xfe references sent, and of bytes not sent as a result
+    size_t nhit = 0u;
+    size_t nsaved = 0u;
+    // re-used for encoding
+    std::vector<uint8_t> scratch;
+};
+
+//! Serialize type, using and updating cache.
+PVXS_API
+void to_wire(Buffer& buf, const FieldDesc* cur, TypeTxCache& cache);
+
 PVXS_API
 void from_wire(Buffer& buf, std::vector<FieldDesc>& descs, TypeStore& cache, unsigned depth=0);
 
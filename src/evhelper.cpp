@@ -14,6 +14,7 @@
 #include <cstring>
 #include <system_error>
 #include <deque>
+#include <atomic>
 #include <limits>
 #include <algorithm>
 
@@ -121,13 +122,35 @@ struct evbase::Pvt final : public epicsThreadRunable
 
     struct Work {
         mfunction fn;
-        std::exception_ptr *result;
-        epicsEvent *notify;
+        std::exception_ptr *result = nullptr;
+        epicsEvent *notify = nullptr;
+        Work() = default;
         Work(mfunction&& fn, std::exception_ptr *result, epicsEvent *notify)
             :fn(std::move(fn)), result(result), notify(notify)
         {}
     };
-    std::deque<Work> actions;
+
+    /* Work queue is a bounded, lock-free, multi-producer, single-consumer ring.
+     * cf. Dmitry Vyukov's bounded MPMC queue.
+     * Slot::seq==pos when free for the producer claiming pos,
+     * and pos+1 once filled for the consumer.
+     *
+     * When the ring is full, producers fall back to the overflow deque (under lock)
+     * until the worker has emptied both.  Preserves ordering from each producer.
+     */
+    struct Slot {
+        std::atomic<size_t> seq{0u};
+        Work work;
+    };
+    static constexpr size_t ringSize = 512u; // power of 2
+    std::unique_ptr<Slot[]> ring;
+    std::atomic<size_t> ringTail{0u}; // next position to be claimed by a producer
+    size_t ringHead = 0u; // next position to be consumed.  only accessed from worker
+    // guarded by lock
+    std::deque<Work> overflow;
+    std::atomic<bool> overflowing{false};
+    // true when dowork is pending
+    std::atomic<bool> armed{false};
 
     evbaseptr base;
     evevent keepalive;
@@ -136,15 +159,21 @@ struct evbase::Pvt final : public epicsThreadRunable
     epicsMutex lock;
 
     epicsThread worker;
-    bool running = true;
+    std::atomic<bool> running{true};
+    // number of threads between enter() and leave().  join() waits for zero.
+    std::atomic<size_t> inflight{0u};
 
     INST_COUNTER(evbase);
 
     Pvt(const std::string& name, unsigned prio)
-        :worker(*this, name.c_str(),
+        :ring(new Slot[ringSize])
+        ,worker(*this, name.c_str(),
                 epicsThreadGetStackSize(epicsThreadStackBig),
                 prio)
     {
+        for(auto i : range(ringSize))
+            ring[i].seq.store(i, std::memory_order_relaxed);
+
         threadOnce<&evthread_init>();
 
         worker.start();
@@ -158,10 +187,11 @@ struct evbase::Pvt final : public epicsThreadRunable
 
     void join()
     {
-        {
-            Guard G(lock);
-            running = false;
-        }
+        running = false;
+        // wait for any concurrent push() to complete, so that everything
+        // queued is ahead of the loopexit below.
+        while(inflight.load())
+            epicsThreadSleep(0.0);
         if(worker.isCurrentThread())
             log_crit_printf(logerr, "evbase self-joining: %s\n", worker.getNameSelf());
         if(event_base_loopexit(base.get(), nullptr))
@@ -209,6 +239,10 @@ struct evbase::Pvt final : public epicsThreadRunable
             auto lvl = ret ? Level::Crit : Level::Info;
             log_printf(logerr, lvl, "Exit loop worker: %d for %p\n", ret, base.get());
 
+            // join() waits for concurrent push()es before interrupting the loop,
+            // and rejects any more.  Run anything left so that no call() waits forever.
+            doWork();
+
         }catch(std::exception& e){
             log_exc_printf(logerr, "Unhandled exception in event_base run : %s\n",
                             e.what());
@@ -216,29 +250,120 @@ struct evbase::Pvt final : public epicsThreadRunable
         }
     }
 
-    void doWork()
+    // from any thread
+    bool tryPush(Work& work)
+    {
+        auto pos = ringTail.load(std::memory_order_relaxed);
+        while(true) {
+            auto& slot = ring[pos & (ringSize-1u)];
+            auto seq = slot.seq.load(std::memory_order_acquire);
+            auto diff = intptr_t(seq) - intptr_t(pos);
+            if(diff==0) {
+                // seq_cst to order against the wakeup() test of armed
+                if(ringTail.compare_exchange_weak(pos, pos+1u, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    slot.work = std::move(work);
+                    slot.seq.store(pos+1u, std::memory_order_release);
+                    return true;
+                }
+                // CAS failure updated pos
+            } else if(diff<0) {
+                return false; // full
+            } else {
+                pos = ringTail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // from any thread.  Returns false, and queues nothing, once join() has started.
+    // Otherwise caller must push() and wakeup(), then leave().
+    bool enter()
     {
-        decltype (actions) todo;
-        {
+        inflight.fetch_add(1u);
+        if(!running.load()) {
+            leave();
+            return false;
+        }
+        return true;
+    }
+    void leave()
+    {
+        inflight.fetch_sub(1u);
+    }
+
+    // from any thread
+    void push(Work&& work)
+    {
+        if(overflowing.load() || !tryPush(work)) {
             Guard G(lock);
-            todo = std::move(actions);
+            overflow.push_back(std::move(work));
+            overflowing = true;
         }
-        for(auto& work : todo) {
-            try {
-                auto fn(std::move(work.fn));
-                fn();
-            }catch(std::exception& e){
-                if(work.result) {
-                    Guard G(lock);
-                    *work.result = std::current_exception();
-                } else {
-                    log_exc_printf(logerr, "Unhandled exception in event_base : %s : %s\n",
-                                    typeid(e).name(), e.what());
-                }
+    }
+
+    // from any thread
+    void wakeup()
+    {
+        if(!armed.exchange(true)) {
+            timeval now{};
+            if(event_add(dowork.get(), &now))
+                throw std::runtime_error("Unable to wakeup evbase");
+        }
+    }
+
+    void runWork(Work& work)
+    {
+        try {
+            auto fn(std::move(work.fn));
+            fn();
+        }catch(std::exception& e){
+            if(work.result) {
+                Guard G(lock);
+                *work.result = std::current_exception();
+            } else {
+                log_exc_printf(logerr, "Unhandled exception in event_base : %s : %s\n",
+                                typeid(e).name(), e.what());
+            }
+        }
+        if(work.notify)
+            work.notify->signal();
+    }
+
+    void doWork()
+    {
+        // cleared before looking at the ring.  Anything queued after this point
+        // will see armed==false, and wakeup() again.
+        armed.store(false);
+
+        // only run work queued before this point.  Anything queued
+        // by callbacks is deferred to the next pass.
+        const auto limit = ringTail.load();
+        while(ringHead!=limit) {
+            auto& slot = ring[ringHead & (ringSize-1u)];
+            if(slot.seq.load(std::memory_order_acquire)!=ringHead+1u)
+                break; // claimed, but not yet filled
+            Work work(std::move(slot.work));
+            slot.seq.store(ringHead+ringSize, std::memory_order_release);
+            ringHead++;
+
+            runWork(work);
+        }
+
+        if(ringHead==ringTail.load() && overflowing.load()) {
+            // ring empty, so everything in overflow was queued later
+            decltype (overflow) todo;
+            {
+                Guard G(lock);
+                todo = std::move(overflow);
+                overflow.clear();
+                overflowing = false;
             }
-            if(work.notify)
-                work.notify->signal();
+            for(auto& work : todo)
+                runWork(work);
         }
+
+        // re-check.  incomplete push, or newly queued.  come back later
+        if(ringHead!=ringTail.load() || overflowing.load())
+            wakeup();
     }
     static
     void doWorkS(evutil_socket_t sock, short evt, void *raw)
@@ -296,21 +421,20 @@ void evbase::sync() const
 
 bool evbase::_dispatch(mfunction&& fn, bool dothrow) const
 {
-    bool empty;
-    {
-        Guard G(pvt->lock);
-        if(!pvt->running) {
-            if(dothrow)
-                throw std::logic_error("Worker stopped");
-            return false;
-        }
-        empty = pvt->actions.empty();
-        pvt->actions.emplace_back(std::move(fn), nullptr, nullptr);
+    if(!pvt->enter()) {
+        if(dothrow)
+            throw std::logic_error("Worker stopped");
+        return false;
     }
 
-    timeval now{};
-    if(empty && event_add(pvt->dowork.get(), &now))
-        throw std::runtime_error("Unable to wakeup dispatch()");
+    try {
+        pvt->push(Pvt::Work(std::move(fn), nullptr, nullptr));
+        pvt->wakeup();
+    }catch(...){
+        pvt->leave();
+        throw;
+    }
+    pvt->leave();
 
     return true;
 }
@@ -325,21 +449,21 @@ bool evbase::_call(mfunction&& fn, bool dothrow) const
     static ThreadEvent done;
 
     std::exception_ptr result;
-    bool empty;
-    {
-        Guard G(pvt->lock);
-        if(!pvt->running) {
-            if(dothrow)
-                throw std::logic_error("Worker stopped");
-            return false;
-        }
-        empty = pvt->actions.empty();
-        pvt->actions.emplace_back(std::move(fn), &result, done.get());
+
+    if(!pvt->enter()) {
+        if(dothrow)
+            throw std::logic_error("Worker stopped");
+        return false;
     }
 
-    timeval now{};
-    if(empty && event_add(pvt->dowork.get(), &now))
-        throw std::runtime_error("Unable to wakeup call()");
+    try {
+        pvt->push(Pvt::Work(std::move(fn), &result, done.get()));
+        pvt->wakeup();
+    }catch(...){
+        pvt->leave();
+        throw;
+    }
+    pvt->leave();
 
     done->wait();
     Guard G(pvt->lock);
@@ -348,6 +472,16 @@ bool evbase::_call(mfunction&& fn, bool dothrow) const
     return true;
 }
 
+bool evbase::_post(mfunction&& fn, bool dothrow) const
+{
+    if(pvt->worker.isCurrentThread()) {
+        fn();
+        return true;
+    }
+
+    return _dispatch(std::move(fn), dothrow);
+}
+
 void evbase::assertInLoop() const
 {
     if(!pvt->worker.isCurrentThread()) {
@@ -358,6 +492,11 @@ void evbase::assertInLoop() const
     }
 }
 
+bool evbase::inLoop() const
+{
+    return pvt->worker.isCurrentThread();
+}
+
 bool evbase::assertInRunningLoop() const
 {
     if(pvt->worker.isCurrentThread())
@@ -936,6 +1075,10 @@ void from_wire(Buffer &buf, SockAddr& val)
 
 bool Buffer::refill(size_t more) { return false; }
 
+bool Buffer::reference(const shared_array<const void>& arr, const void* data, size_t nbytes) { return false; }
+
+bool Buffer::copyout(void* dest, size_t nbytes) { return false; }
+
 FixedBuf::~FixedBuf() {}
 
 VectorOutBuf::~VectorOutBuf() {}
@@ -985,8 +1128,113 @@ bool EvOutBuf::refill(size_t more)
     return true;
 }
 
+static
+void releaseArray(const void *data, size_t datalen, void *raw)
+{
+    delete static_cast<shared_array<const void>*>(raw);
+}
+
+bool EvOutBuf::reference(const shared_array<const void>& arr, const void* data, size_t nbytes)
+{
+    if(err || !refThreshold || nbytes < refThreshold)
+        return false;
+
+    // commit what has been written so far
+    if(!refill(0))
+        return false;
+
+    // keep the array alive until libevent is done with the chunk.
+    // data is not modified as shared_array<const void> is immutable.
+    auto holder = new shared_array<const void>(arr);
+    if(evbuffer_add_reference(backing, data, nbytes, &releaseArray, holder)) {
+        delete holder;
+        return false;
+    }
+    return true;
+}
+
 EvInBuf::~EvInBuf() { refill(0); }
 
+ArrayPool::~ArrayPool()
+{
+    for(auto& pair : unused)
+        delete[] pair.second;
+}
+
+std::shared_ptr<void> ArrayPool::allocate(size_t nbytes)
+{
+    char* mem = nullptr;
+    {
+        Guard G(lock);
+        for(auto it(unused.begin()), end(unused.end()); it!=end; ++it) {
+            if(it->first==nbytes) {
+                mem = it->second;
+                *it = unused.back();
+                unused.pop_back();
+                break;
+            }
+        }
+        if(mem)
+            nreuse++;
+        else
+            nalloc++;
+    }
+    if(!mem)
+        mem = new char[nbytes];
+
+    std::weak_ptr<ArrayPool> wself(shared_from_this());
+    try {
+        return std::shared_ptr<void>(mem, [wself, nbytes](char* mem) {
+            // maybe on worker or user thread
+            release(wself, mem, nbytes);
+        });
+    }catch(...){
+        delete[] mem;
+        throw;
+    }
+}
+
+void ArrayPool::release(const std::weak_ptr<ArrayPool>& wself, char* mem, size_t nbytes)
+{
+    if(auto self = wself.lock()) {
+        Guard G(self->lock);
+        if(self->unused.size() < self->limit) {
+            self->unused.emplace_back(nbytes, mem);
+            return;
+        }
+    }
+    delete[] mem;
+}
+
+void ArrayPool::stats(size_t& nreuse, size_t& nalloc, bool reset)
+{
+    Guard G(lock);
+    nreuse = this->nreuse;
+    nalloc = this->nalloc;
+    if(reset)
+        this->nreuse = this->nalloc = 0u;
+}
+
+bool EvInBuf::copyout(void* dest, size_t nbytes)
+{
+    if(err)
+        return false;
+
+    // drain consumed, and release our view of the current segment
+    if(!refill(0))
+        return false;
+
+    if(evbuffer_get_length(backing) < nbytes)
+        return false; // caller will fault on truncation
+
+    // copies from each segment in turn, freeing segments as they are emptied.
+    // Avoids the pullup() of refill() across segment boundaries.
+    auto n = evbuffer_remove(backing, dest, nbytes);
+    if(n<0 || size_t(n)!=nbytes)
+        fault(__FILE__, __LINE__);
+    return true;
+}
+
 bool EvInBuf::refill(size_t needed)
 {
     if(err) return false;
@@ -10,7 +10,10 @@
 #include <sstream>
 #include <functional>
 #include <memory>
+#include <new>
 #include <string>
+#include <vector>
+#include <type_traits>
 #include <map>
 #include <set>
 
@@ -117,6 +120,9 @@ struct owned_ptr : public std::unique_ptr<T, D>
  * std::function<void()> fn(std::move(lambda));
  *
  * So we invent our own limited, non-copyable, version of std::function<void()>.
+ *
+ * Small functors (eg. a lambda capturing a shared_ptr or two) are stored inline
+ * to avoid a heap allocation for each evbase::dispatch().
  */
 namespace mdetail {
 struct PVXS_API VFunctor0 {
@@ -126,14 +132,19 @@ struct PVXS_API VFunctor0 {
     VFunctor0& operator=(const VFunctor0&) = delete;
     virtual ~VFunctor0() =0;
     virtual void invoke() =0;
+    // move construct into (inline) storage at dest
+    virtual VFunctor0* moveTo(void* dest) noexcept =0;
 };
 template<typename Fn>
 struct Functor0 final : public VFunctor0 {
-    Functor0() = default;
-    Functor0(Fn&& fn) : fn(std::move(fn)) {}
+    template<typename A>
+    explicit Functor0(A&& fn) : fn(std::forward<A>(fn)) {}
     virtual ~Functor0() {}
 
     void invoke() override final { fn(); }
+    VFunctor0* moveTo(void* dest) noexcept override final {
+        return new (dest) Functor0(std::move(fn));
+    }
 private:
     Fn fn;
 };
@@ -141,18 +152,64 @@ private:
 
 struct mfunction {
     mfunction() = default;
-    template<typename Fn>
+    template<typename Fn,
+             typename F = typename std::decay<Fn>::type,
+             typename std::enable_if<!std::is_same<F, mfunction>::value, int>::type = 0>
     mfunction(Fn&& fn)
-        :fn{new mdetail::Functor0<Fn>(std::move(fn))}
-    {}
+    {
+        typedef mdetail::Functor0<F> functor_t;
+        emplace<functor_t>(std::forward<Fn>(fn), std::integral_constant<bool,
+                           sizeof(functor_t) <= sizeof(store)
+                           && alignof(functor_t) <= alignof(decltype(store))
+                           && std::is_nothrow_move_constructible<F>::value>{});
+    }
+    mfunction(const mfunction&) = delete;
+    mfunction& operator=(const mfunction&) = delete;
+    mfunction(mfunction&& o) noexcept { take(o); }
+    mfunction& operator=(mfunction&& o) noexcept {
+        if(this!=&o) {
+            clear();
+            take(o);
+        }
+        return *this;
+    }
+    ~mfunction() { clear(); }
+
     void operator()() const {
         fn->invoke();
     }
     explicit operator bool() const {
-        return fn.operator bool();
+        return fn!=nullptr;
     }
 private:
-    std::unique_ptr<mdetail::VFunctor0> fn;
+    template<typename functor_t, typename Fn>
+    void emplace(Fn&& fn, std::true_type) {
+        this->fn = new (&store) functor_t(std::forward<Fn>(fn));
+    }
+    template<typename functor_t, typename Fn>
+    void emplace(Fn&& fn, std::false_type) {
+        this->fn = new functor_t(std::forward<Fn>(fn));
+    }
+    bool isInline() const { return static_cast<const void*>(fn)==static_cast<const void*>(&store); }
+    void take(mfunction& o) noexcept {
+        if(o.isInline()) {
+            fn = o.fn->moveTo(&store);
+            o.clear();
+        } else {
+            fn = o.fn;
+            o.fn = nullptr;
+        }
+    }
+    void clear() noexcept {
+        if(isInline())
+            fn->~VFunctor0();
+        else
+            delete fn;
+        fn = nullptr;
+    }
+
+    mdetail::VFunctor0* fn = nullptr;
+    typename std::aligned_storage<6u*sizeof(void*)>::type store;
 };
 
 struct PVXS_API evbase {
@@ -169,6 +226,7 @@ struct PVXS_API evbase {
 private:
     bool _dispatch(mfunction&& fn, bool dothrow) const;
     bool _call(mfunction&& fn, bool dothrow) const;
+    bool _post(mfunction&& fn, bool dothrow) const;
 public:
 
     // queue request to execute in event loop.  return after executed.
@@ -191,6 +249,13 @@ public:
         return _dispatch(std::move(fn), false);
     }
 
+    // execute in event loop.  Immediately when called from the event loop,
+    // otherwise queue request and return immediately.
+    inline
+    void post(mfunction&& fn) const {
+        _post(std::move(fn), true);
+    }
+
     bool tryInvoke(bool docall, mfunction&& fn) const {
         if(docall)
             return tryCall(std::move(fn));
@@ -199,6 +264,8 @@ public:
     }
 
     void assertInLoop() const;
+    //! @returns true when called from the event loop thread
+    bool inLoop() const;
     //! Caller must be on the worker, or the worker must be stopped.
     //! @returns true if working is running.
     bool assertInRunningLoop() const;
@@ -134,6 +134,30 @@ int recvfromx::call()
     }
 }
 
+int recvfromx::callMany(recvfromx* ops, size_t nops)
+{
+    // no batch receive.  one at a time
+    size_t n;
+    for(n=0u; n<nops; n++) {
+        ops[n].nrx = ops[n].call();
+        if(ops[n].nrx<0)
+            break;
+    }
+    return n ? int(n) : -1;
+}
+
+size_t sendtoMany(evutil_socket_t sock, const void* buf, size_t buflen,
+                  const SockAddr* const* dests, size_t ndest)
+{
+    size_t nsent;
+    for(nsent=0u; nsent<ndest; nsent++) {
+        const auto& dest = *dests[nsent];
+        if(sendto(sock, (const char*)buf, int(buflen), 0, &dest->sa, dest.size())<0)
+            break;
+    }
+    return nsent;
+}
+
 namespace impl {
 
 #ifndef GAA_FLAG_INCLUDE_ALL_INTERFACES
@@ -13,6 +13,8 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 #include <sys/types.h>
 #include <net/if.h>
 #include <ifaddrs.h>
@@ -103,100 +105,207 @@ void evsocket::enable_IP_PKTINFO() const
     }
 }
 
-int recvfromx::call()
-{
-    msghdr msg{};
-
-    iovec iov = {buf, buflen};
-    msg.msg_iov = &iov;
-    msg.msg_iovlen = 1u;
-
-    msg.msg_name = &(*src)->sa;
-    msg.msg_namelen = src ? src->size() : 0u;
-
-    alignas (cmsghdr) char cbuf[0u
+// control message space for recvfromx
+static constexpr size_t recvfromxCtrlSize = 0u
 #ifdef SO_RXQ_OVFL
-            + CMSG_SPACE(sizeof(ndrop))
+        + CMSG_SPACE(sizeof(uint32_t))
 #endif
-            // only need space for IPv4 option(s) or IPv6 option, never both.
-            + impl::cmax(0
+        // only need space for IPv4 option(s) or IPv6 option, never both.
+        + impl::cmax(0
 #ifdef IP_PKTINFO
-            + CMSG_SPACE(sizeof(in_pktinfo))
+        + CMSG_SPACE(sizeof(in_pktinfo))
 #else
 #  if defined(IP_ORIGDSTADDR)
-            + CMSG_SPACE(sizeof(sockaddr_in))
+        + CMSG_SPACE(sizeof(sockaddr_in))
 #  endif
 #  if defined(IP_RECVIF)
-            + CMSG_SPACE(sizeof(sockaddr_dl))
+        + CMSG_SPACE(sizeof(sockaddr_dl))
 #  endif
 #endif
-                  ,0
-            + CMSG_SPACE(sizeof(in6_pktinfo))
-                  ) // cmax
-            ];
-    msg.msg_control = cbuf;
-    msg.msg_controllen = sizeof(cbuf);
-
-    if(dst)
-        *dst = SockAddr();
-    dstif = -1;
-    ndrop = 0u;
+              ,0
+        + CMSG_SPACE(sizeof(in6_pktinfo))
+              ); // cmax
 
-    int ret = recvmsg(sock, &msg, 0);
+namespace {
+struct alignas (cmsghdr) recvfromxCtrl {
+    char buf[recvfromxCtrlSize];
+};
+
+void prepare(recvfromx& op, msghdr& msg, iovec& iov, recvfromxCtrl& cbuf)
+{
+    iov = {op.buf, op.buflen};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1u;
+
+    msg.msg_name = &(*op.src)->sa;
+    msg.msg_namelen = op.src ? op.src->size() : 0u;
+
+    msg.msg_control = cbuf.buf;
+    msg.msg_controllen = sizeof(cbuf.buf);
+
+    if(op.dst)
+        *op.dst = SockAddr();
+    op.dstif = -1;
+    op.ndrop = 0u;
+}
+
+// on success, check for control messages
+void complete(recvfromx& op, msghdr& msg)
+{
+    auto dst = op.dst;
 
-    if(ret>=0) { // on success, check for control messages
-        if(msg.msg_flags & MSG_CTRUNC)
-            log_warn_printf(log, "MSG_CTRUNC, expand buffer %zu <- %zu\n", size_t(msg.msg_controllen), sizeof(cbuf));
+    if(msg.msg_flags & MSG_CTRUNC)
+        log_warn_printf(log, "MSG_CTRUNC, expand buffer %zu <- %zu\n", size_t(msg.msg_controllen), recvfromxCtrlSize);
 
-        for(cmsghdr *hdr = CMSG_FIRSTHDR(&msg); hdr ; hdr = CMSG_NXTHDR(&msg, hdr)) {
-            if(0) {}
+    for(cmsghdr *hdr = CMSG_FIRSTHDR(&msg); hdr ; hdr = CMSG_NXTHDR(&msg, hdr)) {
+        if(0) {}
 #ifdef SO_RXQ_OVFL
-            else if(hdr->cmsg_level==SOL_SOCKET && hdr->cmsg_type==SO_RXQ_OVFL && hdr->cmsg_len>=CMSG_LEN(sizeof(ndrop))) {
-                memcpy(&ndrop, CMSG_DATA(hdr), sizeof(ndrop));
-            }
+        else if(hdr->cmsg_level==SOL_SOCKET && hdr->cmsg_type==SO_RXQ_OVFL && hdr->cmsg_len>=CMSG_LEN(sizeof(op.ndrop))) {
+            memcpy(&op.ndrop, CMSG_DATA(hdr), sizeof(op.ndrop));
+        }
 #endif
 #ifdef IP_PKTINFO
-            else if(hdr->cmsg_level==IPPROTO_IP && hdr->cmsg_type==IP_PKTINFO && hdr->cmsg_len>=CMSG_LEN(sizeof(in_pktinfo))) {
-                if(dst) {
-                    (*dst)->in.sin_family = AF_INET;
-                    memcpy(&(*dst)->in.sin_addr, CMSG_DATA(hdr) + offsetof(in_pktinfo, ipi_addr), sizeof(in_addr_t));
-                }
-
-                decltype(in_pktinfo::ipi_ifindex) idx;
-                memcpy(&idx, CMSG_DATA(hdr) + offsetof(in_pktinfo, ipi_ifindex), sizeof(idx));
-                dstif = idx;
+        else if(hdr->cmsg_level==IPPROTO_IP && hdr->cmsg_type==IP_PKTINFO && hdr->cmsg_len>=CMSG_LEN(sizeof(in_pktinfo))) {
+            if(dst) {
+                (*dst)->in.sin_family = AF_INET;
+                memcpy(&(*dst)->in.sin_addr, CMSG_DATA(hdr) + offsetof(in_pktinfo, ipi_addr), sizeof(in_addr_t));
             }
 
+            decltype(in_pktinfo::ipi_ifindex) idx;
+            memcpy(&idx, CMSG_DATA(hdr) + offsetof(in_pktinfo, ipi_ifindex), sizeof(idx));
+            op.dstif = idx;
+        }
+
 #else
 #  ifdef IP_ORIGDSTADDR
-            else if(dst && hdr->cmsg_level==IPPROTO_IP && hdr->cmsg_type==IP_ORIGDSTADDR && hdr->cmsg_len>=CMSG_LEN(sizeof(sockaddr_in))) {
-                memcpy(&(*dst)->in, CMSG_DATA(hdr), sizeof(sockaddr_in));
-            }
+        else if(dst && hdr->cmsg_level==IPPROTO_IP && hdr->cmsg_type==IP_ORIGDSTADDR && hdr->cmsg_len>=CMSG_LEN(sizeof(sockaddr_in))) {
+            memcpy(&(*dst)->in, CMSG_DATA(hdr), sizeof(sockaddr_in));
+        }
 #  endif
 #  ifdef IP_RECVIF
-            else if(dst && hdr->cmsg_level==IPPROTO_IP && hdr->cmsg_type==IP_RECVIF && hdr->cmsg_len>=CMSG_LEN(sizeof(sockaddr_dl))) {
-                decltype (sockaddr_dl::sdl_index) idx;
-                memcpy(&idx, CMSG_DATA(hdr) + offsetof(sockaddr_dl, sdl_index), sizeof(idx));
-                dstif = idx;
-            }
+        else if(dst && hdr->cmsg_level==IPPROTO_IP && hdr->cmsg_type==IP_RECVIF && hdr->cmsg_len>=CMSG_LEN(sizeof(sockaddr_dl))) {
+            decltype (sockaddr_dl::sdl_index) idx;
+            memcpy(&idx, CMSG_DATA(hdr) + offsetof(sockaddr_dl, sdl_index), sizeof(idx));
+            op.dstif = idx;
+        }
 #  endif
 #endif
-            else if(hdr->cmsg_level==IPPROTO_IPV6 && hdr->cmsg_type==IPV6_PKTINFO && hdr->cmsg_len>=CMSG_LEN(sizeof(in6_pktinfo))) {
-                if(dst) {
-                    (*dst)->in6.sin6_family = AF_INET6;
-                    memcpy(&(*dst)->in6.sin6_addr, CMSG_DATA(hdr) + offsetof(in6_pktinfo, ipi6_addr), sizeof(in6_addr));
-                }
-
-                decltype(in6_pktinfo::ipi6_ifindex) idx;
-                memcpy(&idx, CMSG_DATA(hdr) + offsetof(in6_pktinfo, ipi6_ifindex), sizeof(idx));
-                dstif = idx;
+        else if(hdr->cmsg_level==IPPROTO_IPV6 && hdr->cmsg_type==IPV6_PKTINFO && hdr->cmsg_len>=CMSG_LEN(sizeof(in6_pktinfo))) {
+            if(dst) {
+                (*dst)->in6.sin6_family = AF_INET6;
+                memcpy(&(*dst)->in6.sin6_addr, CMSG_DATA(hdr) + offsetof(in6_pktinfo, ipi6_addr), sizeof(in6_addr));
             }
+
+            decltype(in6_pktinfo::ipi6_ifindex) idx;
+            memcpy(&idx, CMSG_DATA(hdr) + offsetof(in6_pktinfo, ipi6_ifindex), sizeof(idx));
+            op.dstif = idx;
         }
     }
+}
+
+#ifdef __linux__
+// max. messages per recvmmsg() or sendmmsg()
+constexpr size_t mmsgBatch = 16u;
+#endif
+} // namespace
+
+int recvfromx::call()
+{
+    msghdr msg{};
+    iovec iov;
+    recvfromxCtrl cbuf;
+
+    prepare(*this, msg, iov, cbuf);
+
+    int ret = recvmsg(sock, &msg, 0);
+
+    if(ret>=0)
+        complete(*this, msg);
 
     return ret;
 }
 
+int recvfromx::callMany(recvfromx* ops, size_t nops)
+{
+#ifdef __linux__
+    if(nops>1u) {
+        mmsghdr msgs[mmsgBatch];
+        iovec iovs[mmsgBatch];
+        recvfromxCtrl cbufs[mmsgBatch];
+
+        if(nops > mmsgBatch)
+            nops = mmsgBatch;
+
+        for(auto i : impl::range(nops)) {
+            msgs[i] = mmsghdr{};
+            prepare(ops[i], msgs[i].msg_hdr, iovs[i], cbufs[i]);
+        }
+
+        // only wait for the first, take whatever else is already queued
+        int ret = recvmmsg(ops[0].sock, msgs, nops, MSG_WAITFORONE, nullptr);
+        if(ret>=0) {
+            for(auto i : impl::range(size_t(ret))) {
+                ops[i].nrx = int(msgs[i].msg_len);
+                complete(ops[i], msgs[i].msg_hdr);
+            }
+            return ret;
+
+        } else if(errno!=ENOSYS) {
+            return -1;
+        }
+        // fall through to one at a time
+    }
+#endif
+
+    size_t n;
+    for(n=0u; n<nops; n++) {
+        ops[n].nrx = ops[n].call();
+        if(ops[n].nrx<0)
+            break;
+    }
+    return n ? int(n) : -1;
+}
+
+size_t sendtoMany(evutil_socket_t sock, const void* buf, size_t buflen,
+                  const SockAddr* const* dests, size_t ndest)
+{
+    size_t nsent = 0u;
+
+#ifdef __linux__
+    while(ndest - nsent > 1u) {
+        mmsghdr msgs[mmsgBatch];
+        iovec iov{const_cast<void*>(buf), buflen};
+
+        auto n = std::min(ndest - nsent, mmsgBatch);
+
+        for(auto i : impl::range(n)) {
+            const auto& dest = *dests[nsent + i];
+            msgs[i] = mmsghdr{};
+            msgs[i].msg_hdr.msg_name = const_cast<sockaddr*>(&dest->sa);
+            msgs[i].msg_hdr.msg_namelen = dest.size();
+            msgs[i].msg_hdr.msg_iov = &iov;
+            msgs[i].msg_hdr.msg_iovlen = 1u;
+        }
+
+        int ret = sendmmsg(sock, msgs, n, 0);
+        if(ret>0) {
+            nsent += size_t(ret);
+        } else if(ret<0 && errno==ENOSYS) {
+            break; // fall back to one at a time
+        } else {
+            return nsent;
+        }
+    }
+#endif
+
+    for(; nsent<ndest; nsent++) {
+        const auto& dest = *dests[nsent];
+        if(sendto(sock, (const char*)buf, buflen, 0, &dest->sa, dest.size())<0)
+            break;
+    }
+    return nsent;
+}
+
 namespace impl {
 
 decltype (IfaceMap::byIndex) IfaceMap::_refresh() {
@@ -209,11 +209,28 @@ struct recvfromx {
     SockAddr* dst;  // if enable_IP_PKTINFO()
     int64_t dstif;  // if enable_IP_PKTINFO(), destination interface index
     uint32_t ndrop; // if enable_SO_RXQ_OVFL()
+    int nrx;        // set by callMany()
 
     PVXS_API
     int call();
+
+    /* Receive up to nops datagrams, one into each ops[i], all from ops[0].sock.
+     * Uses a single recvmmsg() where available.  Sets ops[i].nrx for each received.
+     * Returns number of datagrams received, or -1 if none (cf. evutil_socket_geterror()).
+     */
+    PVXS_API
+    static int callMany(recvfromx* ops, size_t nops);
 };
 
+/* Send the same datagram to each of ndest destinations.
+ * Uses sendmmsg() where available.
+ * Returns the number of leading destinations sent to.
+ * When less than ndest, dests[ret] failed, cf. evutil_socket_geterror().
+ */
+PVXS_API
+size_t sendtoMany(evutil_socket_t sock, const void* buf, size_t buflen,
+                  const SockAddr* const* dests, size_t ndest);
+
 } // namespace pvxs
 
 #endif // OSISOCKEXT_H
@@ -8,16 +8,19 @@
 #define PVAPROTO_H
 
 #include <compilerDependencies.h>
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <vector>
 #include <string>
+#include <memory>
 #include <type_traits>
 #include <initializer_list>
 
 #include <type_traits>
 
 #include <epicsEndian.h>
+#include <epicsMutex.h>
 
 #include <event2/buffer.h>
 #include <pvxs/version.h>
@@ -26,6 +29,34 @@
 
 namespace pvxs {namespace impl {
 
+/* Recycles the storage of received arrays.  Storage allocated from a pool
+ * returns to it when the last reference is released, and is re-used
+ * for a later array of the same size in bytes.
+ */
+struct PVXS_API ArrayPool : public std::enable_shared_from_this<ArrayPool> {
+    // smaller arrays are not worth recycling
+    static constexpr size_t minBytes = 4096u;
+    // max. number of unused buffers retained
+    const size_t limit;
+
+    explicit ArrayPool(size_t limit) :limit(limit) {
+        unused.reserve(limit); // so release() need not allocate
+    }
+    ~ArrayPool();
+
+    std::shared_ptr<void> allocate(size_t nbytes);
+
+    // number of allocate() calls which re-used storage, or did not
+    void stats(size_t& nreuse, size_t& nalloc, bool reset);
+
+private:
+    static void release(const std::weak_ptr<ArrayPool>& wself, char* mem, size_t nbytes);
+
+    epicsMutex lock;
+    std::vector<std::pair<size_t, char*>> unused;
+    size_t nreuse = 0u, nalloc = 0u;
+};
+
 constexpr bool hostBE{EPICS_BYTE_ORDER==EPICS_ENDIAN_BIG};
 
 //! view of a slice of a buffer.
@@ -45,11 +76,21 @@ protected:
     virtual bool refill(size_t more);
 
     constexpr Buffer(bool be, uint8_t* buf, size_t n) :pos(buf), limit(buf+n), be(be) {}
+public:
+    // Append nbytes from data, which is owned by arr, without copying.
+    // Returns false if not supported, in which case caller must copy.
+    virtual bool reference(const shared_array<const void>& arr, const void* data, size_t nbytes);
+    // Remove exactly nbytes, copying into dest.
+    // Returns false if not supported, in which case caller must copy.
+    virtual bool copyout(void* dest, size_t nbytes);
+protected:
     virtual ~Buffer() {}
 public:
     Buffer(const Buffer&) = delete;
     Buffer& operator=(const Buffer&) = delete;
     bool be;
+    // when set, from_wire() of large arrays takes storage from this pool
+    ArrayPool* arrayPool = nullptr;
 
     // all sub-classes define
     //   bool refill(size_t more)
@@ -135,6 +176,9 @@ class PVXS_API EvOutBuf : public Buffer
     evbuffer * const backing;
     uint8_t* base; // original pos
 public:
+    // Arrays of at least this many bytes, which need no byte order swap,
+    // are referenced by the evbuffer instead of copied.  Zero disables.
+    size_t refThreshold = 0u;
 
     EvOutBuf(bool be, evbuffer *b, size_t isize=0)
         :base_type(be, nullptr, 0)
@@ -143,6 +187,7 @@ public:
     {refill(isize);}
     virtual ~EvOutBuf();
     virtual bool refill(size_t more) override final;
+    virtual bool reference(const shared_array<const void>& arr, const void* data, size_t nbytes) override final;
 };
 
 //! deserialize from an evbuffer, possibly segmented
@@ -161,6 +206,7 @@ public:
     virtual ~EvInBuf();
 
     virtual bool refill(size_t more) override final;
+    virtual bool copyout(void* dest, size_t nbytes) override final;
 };
 
 // assumes prior buf.ensure(M) where M>=N
@@ -471,6 +517,26 @@ void from_wire(Buffer& buf, Status& sts)
     }
 }
 
+/* Copy nbytes from src to dest, reversing the byte order of each esize byte element.
+ * nbytes must be a multiple of esize.  dest may equal src, but may not otherwise overlap.
+ * Uses SIMD instructions where available.
+ */
+PVXS_API
+void swapCopy(void* dest, const void* src, size_t nbytes, size_t esize);
+
+//! Name of swapCopy() implementation selected for this CPU
+PVXS_API
+const char* swapCopyImpl();
+
+//! Names of all swapCopy() implementations usable on this CPU, the selected one first.  For testing.
+PVXS_API
+std::vector<std::string> swapCopyImpls();
+
+//! swapCopy() using the named implementation.  For testing.
+//! @throws std::logic_error if impl is not one of swapCopyImpls()
+PVXS_API
+void swapCopyWith(const std::string& impl, void* dest, const void* src, size_t nbytes, size_t esize);
+
 template<typename E, typename C = E>
 static inline
 void to_wire(Buffer& buf, const shared_array<const void>& varr)
@@ -482,8 +548,12 @@ void to_wire(Buffer& buf, const shared_array<const void>& varr)
         // optimize handling of types with fixed element size
 
         auto src = reinterpret_cast<const char*>(arr.data());
+        size_t nremain = arr.size()*sizeof(C);
 
-        for(size_t nremain = arr.size()*sizeof(C); nremain;) {
+        if(buf.be==hostBE && nremain && buf.reference(varr, src, nremain))
+            return; // already in native order, append without copy
+
+        while(nremain) {
             if(!buf.ensure(sizeof(C))) {
                 buf.fault(__FILE__, __LINE__);
                 break;
@@ -496,14 +566,7 @@ void to_wire(Buffer& buf, const shared_array<const void>& varr)
                 memcpy(buf.save(), src, nbytes);
 
             } else { // must swap byte order
-                auto dest = buf.save();
-
-                for(size_t i=0; i<nbytes; i+=sizeof(C)) {
-                    for(size_t n=0u; n<sizeof(C); n++) {
-                        dest[i + sizeof(C)-1-n] = src[i + n];
-
-                    }
-                }
+                swapCopy(buf.save(), src, nbytes, sizeof(C));
             }
 
             src += nbytes;
@@ -525,14 +588,32 @@ void from_wire(Buffer& buf, shared_array<const void>& varr)
 {
     Size slen{};
     from_wire(buf, slen);
-    shared_array<E> arr(slen.size);
+    shared_array<E> arr;
+    if(buf.arrayPool && buf.good() && std::is_pod<C>::value && sizeof(E)==sizeof(C)
+            && slen.size*sizeof(E) >= ArrayPool::minBytes)
+    {
+        // all elements overwritten below, so no need to initialize
+        auto store(buf.arrayPool->allocate(slen.size*sizeof(E)));
+        arr = shared_array<E>(std::shared_ptr<E>(store, static_cast<E*>(store.get())), slen.size);
+    } else {
+        arr = shared_array<E>(slen.size);
+    }
 
     if(std::is_pod<C>::value) {
         // optimize handling of types with fixed element size
 
         auto dest = reinterpret_cast<char*>(arr.data());
+        size_t nremain = arr.size()*sizeof(C);
+
+        if(nremain && buf.copyout(dest, nremain)) {
+            // copied directly from backing buffer segments.  swap in place if needed.
+            if(buf.be!=hostBE) {
+                swapCopy(dest, dest, nremain, sizeof(C));
+            }
+            nremain = 0u;
+        }
 
-        for(size_t nremain = arr.size()*sizeof(C); nremain;) {
+        while(nremain) {
             if(!buf.ensure(sizeof(C))) {
                 buf.fault(__FILE__, __LINE__);
                 break;
@@ -545,14 +626,7 @@ void from_wire(Buffer& buf, shared_array<const void>& varr)
                 memcpy(dest, buf.save(), nbytes);
 
             } else { // must swap byte order
-                auto src = buf.save();
-
-                for(size_t i=0; i<nbytes; i+=sizeof(C)) {
-                    for(size_t n=0u; n<sizeof(C); n++) {
-                        dest[i + sizeof(C)-1-n] = src[i + n];
-
-                    }
-                }
+                swapCopy(dest, buf.save(), nbytes, sizeof(C));
             }
 
             dest += nbytes;
@@ -4,12 +4,18 @@
  * in file LICENSE that is included with this distribution.
  */
 
+#include <algorithm>
+
+#include <epicsGuard.h>
+
 #include "pvrequest.h"
 #include "dataimpl.h"
 
 namespace pvxs {
 namespace impl {
 
+typedef epicsGuard<epicsMutex> Guard;
+
 BitMask request2mask(const FieldDesc* desc, const Value& pvRequest)
 {
     auto fields = pvRequest["field"];
@@ -92,4 +98,103 @@ bool testmask(const Value& update, const BitMask& mask)
     return false;
 }
 
+RequestPlan::RequestPlan(const FieldDesc* desc, const Value& pvRequest)
+    :mask(request2mask(desc, pvRequest))
+{
+    for(auto idx = mask.findSet(1u); idx<mask.size(); idx = mask.findSet(idx+1u))
+        selected.push_back(idx);
+}
+
+bool RequestPlan::test(const Value& update) const
+{
+    auto desc = Value::Helper::desc(update);
+    auto store = Value::Helper::store_ptr(update);
+
+    if(!desc)
+        return false;
+
+    if(store->valid) // mask[0] always set
+        return true;
+
+    if(desc->code==TypeCode::Struct) {
+        for(auto idx : selected) {
+            if(store[idx].valid)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+namespace {
+// canonical form of the field selection of a pvRequest.  only those aspects used by request2mask().
+// Members not found in the type are ignored, as request2mask() does.
+std::string requestKey(const FieldDesc* desc, const Value& pvRequest)
+{
+    auto fields = pvRequest["field"];
+
+    if(!fields.valid())
+        return "*";
+    if(fields.type()!=TypeCode::Struct)
+        return "!";
+
+    auto rdesc = Value::Helper::desc(fields);
+    if(rdesc->mlookup.empty())
+        return "*"; // empty is wildcard
+
+    std::string ret("{");
+    // mlookup is sorted by name, so member order doesn't matter
+    for(auto& pair : rdesc->mlookup) {
+        auto crdesc = rdesc + pair.second;
+        if(crdesc->code!=TypeCode::Struct || desc->mlookup.find(pair.first)==desc->mlookup.end())
+            continue;
+        ret += pair.first;
+        if(crdesc->mlookup.empty())
+            ret += '.';
+        ret += ',';
+    }
+    if(ret.size()==1u)
+        return "!"; // nothing selected
+    return ret;
+}
+} // namespace
+
+std::shared_ptr<const RequestPlan> RequestPlanCache::lookup(const std::shared_ptr<const FieldDesc>& type,
+                                                            const Value& pvRequest)
+{
+    auto key(std::make_pair(type.get(), requestKey(type.get(), pvRequest)));
+
+    {
+        Guard G(lock);
+        auto it(entries.find(key));
+        if(it!=entries.end() && it->second.type.lock()==type) {
+            if(auto plan = it->second.plan.lock()) {
+                nhit++;
+                return plan;
+            }
+        }
+    }
+
+    // may throw
+    std::shared_ptr<const RequestPlan> plan(std::make_shared<RequestPlan>(type.get(), pvRequest));
+
+    Guard G(lock);
+    nmiss++;
+
+    if(entries.size() >= purgeAt) {
+        for(auto it = entries.begin(); it!=entries.end();) {
+            if(it->second.type.expired() || it->second.plan.expired())
+                it = entries.erase(it);
+            else
+                ++it;
+        }
+        purgeAt = std::max(size_t(16u), 2u*entries.size());
+    }
+
+    auto& ent = entries[key];
+    ent.type = type;
+    ent.plan = plan;
+    return plan;
+}
+
 }} // namespace pvxs::impl
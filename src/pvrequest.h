@@ -6,6 +6,13 @@
 #ifndef PVREQUEST_H
 #define PVREQUEST_H
 
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <epicsMutex.h>
+
 #include "utilpvt.h"
 #include "bitmask.h"
 #include <pvxs/data.h>
@@ -19,6 +26,41 @@ BitMask request2mask(const FieldDesc* desc, const Value& pvRequest);
 PVXS_API
 bool testmask(const Value& update, const BitMask& mask);
 
+//! pvRequest field selection compiled against one type.  Immutable once built.
+struct PVXS_API RequestPlan {
+    // as from request2mask()
+    BitMask mask;
+    // offsets of selected fields, excluding the top (always selected)
+    std::vector<size_t> selected;
+
+    RequestPlan(const FieldDesc* desc, const Value& pvRequest);
+
+    //! Equivalent to testmask(update, mask) for an update of the type this plan was built for.
+    bool test(const Value& update) const;
+};
+
+/* Shares RequestPlans among operations with the same type and the same pvRequest field selection.
+ * eg. many clients subscribing to one PV with the same pvRequest.
+ */
+struct PVXS_API RequestPlanCache {
+    struct Entry {
+        // detect re-use of the address of an expired type
+        std::weak_ptr<const FieldDesc> type;
+        // operations hold the strong references
+        std::weak_ptr<const RequestPlan> plan;
+    };
+
+    epicsMutex lock;
+    // keyed by type, and the canonical form of those pvRequest .field members which match the type
+    std::map<std::pair<const FieldDesc*, std::string>, Entry> entries;
+    // purge entries with an expired type or plan when size() reaches this
+    size_t purgeAt = 16u;
+    size_t nhit = 0u, nmiss = 0u;
+
+    //! @throws std::runtime_error as request2mask()
+    std::shared_ptr<const RequestPlan> lookup(const std::shared_ptr<const FieldDesc>& type, const Value& pvRequest);
+};
+
 }} // namespace pvxs::impl
 
 #endif // PVREQUEST_H
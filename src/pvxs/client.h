@@ -170,6 +170,10 @@ struct SubscriptionStat {
     size_t maxQueue=0;
     //! Limit on queue size
     size_t limitQueue=0;
+    //! Number of received arrays which re-used storage released by earlier updates,
+    //! and number which needed new storage.  Only arrays of at least 4 KiB are counted.
+    //! @since UNRELEASED
+    size_t nArrayReuse=0, nArrayAlloc=0;
 };
 
 //! Handle for monitor subscription
@@ -661,6 +665,8 @@ public:
      * - block     : bool
      * - process   : bool or string "true", "false", or "passive"
      * - pipeline  : bool
+     * - maxRate   : positive real.  Monitor updates per second sent by a PVXS server.
+     *               Updates in between are merged.  (@since UNRELEASED)
      *
      * A more efficient alternative to @code pvRequest("record[key=value]") @endcode
      */
@@ -897,6 +903,29 @@ public:
     PVXS_API
     std::shared_ptr<Subscription> exec();
 
+    /** Submit requests to subscribe to several PVs with the same options.
+     *
+     *  Equivalent to calling exec() once for each name, with the name passed to
+     *  Context::monitor() replaced.  Cheaper for large numbers of PVs as the
+     *  pvRequest is built once, and all are created in one visit to the client worker.
+     *
+     *  @code
+     *  Context ctxt(...);
+     *  std::vector<std::string> names{"pv:1", "pv:2"};
+     *  auto subs(ctxt.monitor(std::string())
+     *                .record("queueSize", 8)
+     *                .event([](Subscription& sub) {
+     *                    ...
+     *                })
+     *                .execMany(names));
+     *  @endcode
+     *
+     *  @returns One Subscription for each name, in the same order.
+     *  @since UNRELEASED
+     */
+    PVXS_API
+    std::vector<std::shared_ptr<Subscription>> execMany(const std::vector<std::string>& names);
+
     friend struct Context::Pvt;
     friend class Context;
 };
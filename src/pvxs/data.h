@@ -487,6 +487,39 @@ struct PVXS_API LookupError : public std::runtime_error
     virtual ~LookupError();
 };
 
+/** Pre-resolved path to a descendant field of a Struct.
+ *
+ * Obtained from Value::handle().  The field name is looked up once,
+ * instead of on each access with Value::operator[].
+ *
+ * A handle may be used with any Value having the same type as the Value
+ * it was resolved from.  eg. created from the same TypeDef, or through Value::cloneEmpty().
+ * With a Value of some other type, access falls back to a lookup by name().
+ *
+ * @code
+ * auto val = nt::NTScalar{TypeCode::Int32}.create();
+ * auto sevr = val.handle("alarm.severity");
+ * for(...) {
+ *     auto update = val.cloneEmpty();
+ *     update[sevr] = 2;
+ * }
+ * @endcode
+ *
+ * @since UNRELEASED
+ */
+class PVXS_API FieldHandle {
+    std::shared_ptr<const impl::FieldDesc> base;
+    std::string _name;
+    size_t offset = 0u;
+    friend class Value;
+public:
+    FieldHandle() = default;
+    //! Field name expression which was resolved
+    inline const std::string& name() const { return _name; }
+    inline bool valid() const { return base.operator bool(); }
+    inline explicit operator bool() const { return valid(); }
+};
+
 /** Generic data container
  *
  * References a single data field, which may be free-standing (eg. "int x = 5;")
@@ -738,6 +771,25 @@ public:
     Value lookup(const std::string& name);
     const Value lookup(const std::string& name) const;
 
+    /** Resolve a descendant field name once for repeated access through operator[](const FieldHandle&).
+     *
+     * Accepts a name of a descendant field, as with lookup(), which does not
+     * traverse through a Union, Any, or array of Struct.  eg. "alarm.severity"
+     *
+     * @throws LookupError If the lookup can not be satisfied
+     * @throws NoField If this Value is empty
+     * @since UNRELEASED
+     */
+    FieldHandle handle(const std::string& name) const;
+
+    /** Access a descendant field through a handle().
+     *
+     * @returns A valid() Value if the descendant field exists, otherwise an invalid Value.
+     * @since UNRELEASED
+     */
+    Value operator[](const FieldHandle& fld);
+    const Value operator[](const FieldHandle& fld) const;
+
     //! Number of child fields.
     //! only Struct, StructA, Union, UnionA return non-zero
     //! \since 1.1.3 correctly return non-zero for StructA and UnionA
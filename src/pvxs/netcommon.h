@@ -12,6 +12,7 @@
 
 #include <string>
 #include <list>
+#include <vector>
 #include <memory>
 
 #include <pvxs/version.h>
@@ -41,12 +42,29 @@ namespace impl {
  * @since 0.2.0
  */
 struct Report {
+    /** Summary of a latency histogram.  Times in seconds.
+     *
+     *  Quantiles are the upper bound of the histogram bucket, which has a resolution of 25%.
+     *  @since UNRELEASED
+     */
+    struct Latency {
+        //! Number of samples
+        size_t count{};
+        //! Quantiles
+        double p50{}, p99{}, p999{};
+        //! Longest time seen
+        double max{};
+    };
+
     //! Info for a single channel (to a particular PV name on a particular server)
     struct Channel {
         //! Channel name.  aka. PV name
         std::string name;
         //! transmit and receive counters in bytes
         size_t tx{}, rx{};
+        //! Time from post() until a monitor update is encoded.  Only from Server::report()
+        //! @since UNRELEASED
+        Latency postToEncode;
         //! Contextual information (maybe) supplied by the Source
         std::shared_ptr<const ReportInfo> info;
     };
@@ -59,12 +77,60 @@ struct Report {
         std::shared_ptr<const server::ClientCredentials> credentials;
         //! transmit and receive counters in bytes
         size_t tx{}, rx{};
+        //! Number of messages queued for transmit, and number of socket writes which sent them.
+        //! @since UNRELEASED
+        size_t txMsgs{}, txWrites{};
+        //! Number of type descriptions sent as a reference to one previously sent,
+        //! and the number of bytes saved by doing so.
+        //! @since UNRELEASED
+        size_t txTypeHits{}, txTypeSaved{};
+        //! Time from queueing a message until the socket write which completes it.
+        //! @since UNRELEASED
+        Latency encodeToWrite;
+        //! Time from post() until a monitor update is encoded, and time monitor updates
+        //! spend waiting for a full TX buffer to drain.  Only from Server::report()
+        //! @since UNRELEASED
+        Latency postToEncode, backlogWait;
+        //! Bytes held for this peer in queued monitor updates and the TCP send buffer.
+        //! Includes storage shared with other peers, eg. one update posted to many subscribers,
+        //! which is counted once in the server total, but here for each peer referencing it.
+        //! Only from Server::report(), and only counted when server::Config::memoryBudget is set.
+        //! @since UNRELEASED
+        size_t heldBytes{};
         //! Channels currently connected through this socket
         std::list<Channel> channels;
     };
 
+    //! Progress of the client search process.  Only from Context::report()
+    //! @since UNRELEASED
+    struct Search {
+        //! Channels which have not yet been searched for
+        size_t pending{};
+        //! Channels which have been searched for, and are waiting for a reply
+        size_t inFlight{};
+        //! Total number of positive search replies received
+        size_t resolved{};
+        //! Recent rate of positive search replies per second
+        double resolvedRate{};
+        //! Current limit on search datagrams sent per second
+        double rate{};
+    } search;
+
+    //! A thread among server::Config::handlerWorkers.  Only from Server::report()
+    //! @since UNRELEASED
+    struct Handler {
+        //! Calls waiting to run, and the most which have been waiting at once
+        size_t queued{}, maxQueued{};
+        //! Time calls spent waiting to run, and time spent running
+        Latency wait, service;
+    };
+
     //! Currently open sockets
     std::list<Connection> connections;
+
+    //! One entry for each server::Config::handlerWorkers thread
+    //! @since UNRELEASED
+    std::vector<Handler> handlers;
 };
 
 struct PVXS_API ReportInfo {
@@ -175,6 +175,60 @@ struct PVXS_API Config {
     //! @since 0.2.0
     double tcpTimeout = 40.0;
 
+    //! Number of worker threads among which TCP connections are distributed.
+    //! Each connection, with all of its channels and operations, is serviced by one worker.
+    //! Zero selects the number of CPUs.  Default is 1.
+    //! @since UNRELEASED
+    unsigned tcpWorkers = 1u;
+
+    //! Number of threads on which Source onGet(), onPut(), and onRPC() handlers are run.
+    //! Calls for one PV name always run on the same thread, and so in the order received.
+    //! Zero (default) runs handlers on the TCP worker which received the request.
+    //! cf. Report::handlers
+    //! @since UNRELEASED
+    unsigned handlerWorkers = 0u;
+
+    //! When sending, array fields of at least this many bytes, which need no byte order swap,
+    //! are referenced instead of copied into the TCP send buffer.
+    //! The array is kept alive until sent.  Zero disables.  Default is 64 KiB.
+    //! @since UNRELEASED
+    size_t zeroCopyThreshold = 64u*1024u;
+
+    //! When positive, sending on a TCP connection is held back for up to this many seconds
+    //! after a reply is queued, so that replies queued in quick succession are sent together.
+    //! Sending begins sooner once txCoalesceBytes are queued.
+    //! Default zero, send as soon as possible.
+    //! @since UNRELEASED
+    double txCoalesceDelay = 0.0;
+
+    //! cf. txCoalesceDelay.  Default 64 KiB.
+    //! @since UNRELEASED
+    size_t txCoalesceBytes = 64u*1024u;
+
+    //! Maximum number of distinct structure type descriptions remembered for each TCP connection.
+    //! A type already sent on a connection is then sent again as a short reference.
+    //! Zero (default) disables, always sending complete type descriptions.
+    //!
+    //! @warning Only enable when all clients decode the type description of a reply
+    //!          before looking up its IOID, as PVXS clients do.
+    //!          Some other clients, eg. pvAccessCPP, discard an INIT reply for an operation
+    //!          which they have already cancelled without decoding it.
+    //!          If that reply defined a cached type, every later reference to it will fail to decode.
+    //! @since UNRELEASED
+    size_t txTypeCache = 0u;
+
+    //! Limit, in bytes, on memory held for all clients by monitor updates queued for sending,
+    //! and by TCP send buffers.  Zero (default) for no limit, and no accounting.
+    //! While exceeded, a subscription which already has an update queued has further updates
+    //! squashed into that one, regardless of its queue size.
+    //! cf. Report::Connection::heldBytes
+    //! @since UNRELEASED
+    size_t memoryBudget = 0u;
+
+    //! While memoryBudget is exceeded, also disconnect the client for which the most memory is held.
+    //! @since UNRELEASED
+    bool memoryBudgetDisconnect = false;
+
     //! Server unique ID.  Only meaningful in readback via Server::config()
     ServerGUID guid{};
 
@@ -73,6 +73,13 @@ struct PVXS_API SharedPV
 
     //! Update the internal data value, and dispatch subscription updates to any clients.
     void post(const Value& val);
+    /** Update the internal data value, and dispatch subscription updates to any clients.
+     *
+     * When no other reference to val remains, subscription updates share it without a copy.
+     * Otherwise, equivalent to post(const Value&).
+     * @since UNRELEASED
+     */
+    void post(Value&& val);
     //! query the internal data value and update the provided Value.
     void fetch(Value& val) const;
     //! Return a (shallow) copy of the internal data value
@@ -28,6 +28,7 @@ public:
 
     //! For GET_FIELD, GET, or PUT.  Inform peer of our data-type.
     //! @throws std::runtime_error if the client pvRequest() field mask does not select any fields of prototype.
+    //! @since UNRELEASED Does not block
     virtual void connect(const Value& prototype) =0;
     //! Indicate that this operation can not be setup
     //! @since 1.2.3 Does not block
@@ -143,6 +144,7 @@ public:
     //! Inform peer of our data-type and acquire control of subscription queue.
     //! The queue is initially stopped.
     //! @throws std::runtime_error if the client pvRequest() field mask does not select any fields of prototype.
+    //! @since UNRELEASED Does not block
     virtual std::unique_ptr<MonitorControlOp> connect(const Value& prototype) =0;
 
     //! Indicate that this operation can not be setup
@@ -32,10 +32,13 @@
 namespace pvxs {
 namespace impl {
 ReportInfo::~ReportInfo() {}
+SearchIndexed::~SearchIndexed() {}
 }
 namespace server {
 using namespace impl;
 
+typedef epicsGuard<epicsMutex> Guard;
+
 DEFINE_LOGGER(serversetup, "pvxs.server.setup");
 DEFINE_LOGGER(serverio, "pvxs.server.io");
 DEFINE_LOGGER(serversearch, "pvxs.server.search");
@@ -92,6 +95,7 @@ Server& Server::addSource(const std::string& name,
         if(ent)
             throw std::runtime_error(SB()<<"Source already registered : ("<<name<<", "<<order<<")");
         ent = src;
+        pvt->updateSearchPlan();
         pvt->beaconChange++;
     }
     return *this;
@@ -109,6 +113,7 @@ std::shared_ptr<Source> Server::removeSource(const std::string& name,  int order
     if(it!=pvt->sources.end()) {
         ret = it->second;
         pvt->sources.erase(it);
+        pvt->updateSearchPlan();
     }
     pvt->beaconChange++;
 
@@ -238,22 +243,167 @@ Report Server::report(bool zero) const
     if(!pvt)
         throw std::logic_error("NULL Server");
 
+    return pvt->report(zero);
+}
+
+void Server::Pvt::enforceBudget()
+{
+    if(!effective.memoryBudgetDisconnect || memoryCheckPending.exchange(true))
+        return;
+
+    auto self(internal_self.lock());
+    if(!self)
+        return;
+
+    // Each worker finds its largest connection.  The last to finish picks the overall worst.
+    // No thread waits for another.
+    struct Search {
+        epicsMutex lock;
+        size_t remaining = 0u;
+        std::shared_ptr<ServerConn> worst;
+        size_t most = 0u;
+    };
+
+    acceptor_loop.dispatch([self]() {
+        if(!self->overBudget()) {
+            self->memoryCheckPending = false;
+            return;
+        }
+
+        auto search(std::make_shared<Search>());
+        search->remaining = self->workers.size();
+
+        for(auto& worker : self->workers) {
+            auto w = worker.get();
+            w->loop.post([self, search, w]() {
+                std::shared_ptr<ServerConn> worst;
+                size_t most = 0u;
+                for(auto& pair : w->connections) {
+                    auto& conn = pair.second;
+                    // shared storage counts against each connection referencing it
+                    auto held = conn->memory ? conn->memory->referenced() : 0u;
+                    if(held > most) {
+                        most = held;
+                        worst = conn;
+                    }
+                }
+
+                {
+                    Guard G(search->lock);
+                    if(most > search->most) {
+                        search->most = most;
+                        search->worst = std::move(worst);
+                    }
+                    if(--search->remaining)
+                        return;
+                }
+
+                self->memoryCheckPending = false;
+
+                auto conn(std::move(search->worst));
+                if(!conn)
+                    return;
+
+                log_warn_printf(serversetup, "Memory budget %zu exceeded.  Disconnect client %s holding %zu bytes\n",
+                                self->effective.memoryBudget, conn->peerName.c_str(), search->most);
+
+                conn->worker->loop.post([conn]() {
+                    if(conn->worker->connections.find(conn.get())==conn->worker->connections.end())
+                        return; // already closed
+                    conn->disconnect();
+                    conn->cleanup();
+                });
+            });
+        }
+    });
+}
+
+void Server::Pvt::collect(const std::function<void(ServerWorker&)>& fn, ServerWorker* only)
+{
+    // when called from a worker, that worker must service requests while waiting
+    auto self(currentWorker());
+
+    struct Job {
+        std::function<void(ServerWorker&)> fn;
+        epicsMutex lock;
+        size_t remaining = 0u;
+        epicsEvent done;
+        epicsEvent* wake = nullptr;
+    };
+    auto job(std::make_shared<Job>());
+    job->fn = fn;
+    job->remaining = only ? 1u : workers.size();
+    job->wake = self ? &self->collectWake : &job->done;
+
+    for(auto& worker : workers) {
+        auto w = worker.get();
+        if(only && only!=w)
+            continue;
+
+        {
+            Guard G(w->collectLock);
+            w->collecting.emplace_back([job, w]() {
+                job->fn(*w);
+                bool last;
+                {
+                    Guard G(job->lock);
+                    last = 0u == --job->remaining;
+                }
+                if(last)
+                    job->wake->signal();
+            });
+        }
+        // in case the worker is itself waiting in collect()
+        w->collectWake.signal();
+        if(w!=self)
+            w->loop.dispatch([w]() { w->runCollect(); });
+    }
+
+    while(true) {
+        if(self)
+            self->runCollect();
+        {
+            Guard G(job->lock);
+            if(!job->remaining)
+                break;
+        }
+        job->wake->wait();
+    }
+}
+
+Report Server::Pvt::report(bool zero)
+{
     Report ret;
 
-    pvt->acceptor_loop.call([this, &ret, zero](){
+    // filled by each worker in parallel, then concatenated in worker order
+    std::vector<std::vector<Report::Connection>> perWorker(workers.size());
 
-        for(auto& pair : pvt->connections) {
+    collect([&perWorker, zero](ServerWorker& worker) {
+        auto& conns = perWorker[worker.index];
+
+        for(auto& pair : worker.connections) {
             auto conn = pair.first;
 
-            ret.connections.emplace_back();
-            auto& sconn = ret.connections.back();
+            conns.emplace_back();
+            auto& sconn = conns.back();
             sconn.peer = conn->peerName;
             sconn.credentials = conn->cred;
             sconn.tx = conn->statTx;
             sconn.rx = conn->statRx;
+            sconn.txMsgs = conn->statTxMsg;
+            sconn.txWrites = conn->statTxWrite;
+            sconn.txTypeHits = conn->txRegistry.nhit;
+            sconn.txTypeSaved = conn->txRegistry.nsaved;
+            conn->statTxLatency.summarize(sconn.encodeToWrite, zero);
+            conn->statPostEncode.summarize(sconn.postToEncode, zero);
+            conn->statBacklog.summarize(sconn.backlogWait, zero);
+            if(conn->memory)
+                sconn.heldBytes = conn->memory->referenced();
 
             if(zero) {
                 conn->statTx = conn->statRx = 0u;
+                conn->statTxMsg = conn->statTxWrite = 0u;
+                conn->txRegistry.nhit = conn->txRegistry.nsaved = 0u;
             }
 
             for(auto& pair : conn->chanBySID) {
@@ -265,15 +415,35 @@ Report Server::report(bool zero) const
                 schan.tx = chan->statTx;
                 schan.rx = chan->statRx;
                 schan.info = chan->reportInfo;
+                if(chan->statPostEncode)
+                    chan->statPostEncode->summarize(schan.postToEncode, zero);
 
                 if(zero) {
                     chan->statTx = chan->statRx = 0u;
                 }
             }
         }
-
     });
 
+    for(auto& conns : perWorker) {
+        for(auto& sconn : conns)
+            ret.connections.push_back(std::move(sconn));
+    }
+
+    ret.handlers.reserve(handlers.size());
+    for(auto& handler : handlers) {
+        ret.handlers.emplace_back();
+        auto& shdl = ret.handlers.back();
+
+        Guard G(handler->lock);
+        shdl.queued = handler->queued.load(std::memory_order_relaxed);
+        shdl.maxQueued = handler->maxQueued;
+        handler->wait.summarize(shdl.wait, zero);
+        handler->service.summarize(shdl.service, zero);
+        if(zero)
+            handler->maxQueued = shdl.queued;
+    }
+
     return ret;
 }
 
@@ -307,7 +477,10 @@ std::ostream& operator<<(std::ostream& strm, const Server& serv)
         if(detail<2)
             return strm;
 
-        serv.pvt->acceptor_loop.call([&serv, &strm, detail](){
+        auto pvt = serv.pvt.get();
+
+        // worker 0 shares acceptor_loop
+        pvt->collect([&serv, &strm, detail](ServerWorker&){
             strm<<indent{}<<"State: ";
             switch(serv.pvt->state) {
 #define CASE(STATE) case Server::Pvt::STATE: strm<< #STATE; break
@@ -322,57 +495,75 @@ std::ostream& operator<<(std::ostream& strm, const Server& serv)
                 strm<<" TCP_Port: "<<first.bind_addr.port();
             }
             strm<<"\n";
+        }, pvt->workers.front().get());
+
+        // one at a time, to keep output in order
+        for(auto& w : pvt->workers) {
+            pvt->collect([&strm, detail](ServerWorker& wk){
+                auto worker = &wk;
+                size_t tx = 0u, rx = 0u;
+                for(auto& pair : worker->connections) {
+                    tx += pair.first->statTx;
+                    rx += pair.first->statRx;
+                }
+                strm<<indent{}<<"Worker"<<worker->index
+                    <<" connections="<<worker->connections.size()
+                    <<" accepted="<<worker->naccepted
+                    <<" TX="<<tx<<" RX="<<rx<<"\n";
 
-            Indented I(strm);
+                Indented I(strm);
 
-            for(auto& pair : serv.pvt->connections) {
-                auto conn = pair.first;
+                for(auto& pair : worker->connections) {
+                    auto conn = pair.first;
 
-                strm<<indent{}<<"Peer"<<conn->peerName
-                    <<" backlog="<<conn->backlog.size()
-                    <<" TX="<<conn->statTx<<" RX="<<conn->statRx
-                    <<" auth="<<conn->cred->method<<"\n";
-                if(detail>2)
-                    strm<<*conn->cred;
+                    strm<<indent{}<<"Peer"<<conn->peerName
+                        <<" backlog="<<conn->backlog.size()
+                        <<" TX="<<conn->statTx<<" RX="<<conn->statRx
+                        <<" TXmsg="<<conn->statTxMsg<<" TXwrite="<<conn->statTxWrite
+                        <<" TXtypeSaved="<<conn->txRegistry.nsaved
+                        <<" auth="<<conn->cred->method<<"\n";
+                    if(detail>2)
+                        strm<<*conn->cred;
 
-                if(detail<=2)
-                    continue;
+                    if(detail<=2)
+                        continue;
 
-                Indented I(strm);
+                    Indented I(strm);
 
-                for(auto& pair : conn->chanBySID) {
-                    auto& chan = pair.second;
-                    strm<<indent{}<<chan->name<<" TX="<<chan->statTx<<" RX="<<chan->statRx<<' ';
+                    for(auto& pair : conn->chanBySID) {
+                        auto& chan = pair.second;
+                        strm<<indent{}<<chan->name<<" TX="<<chan->statTx<<" RX="<<chan->statRx<<' ';
 
-                    if(chan->state==ServerChan::Creating) {
-                        strm<<"CREATING sid="<<chan->sid<<" cid="<<chan->cid<<"\n";
-                    } else if(chan->state==ServerChan::Destroy) {
-                        strm<<"DESTROY  sid="<<chan->sid<<" cid="<<chan->cid<<"\n";
-                    } else if(chan->opByIOID.empty()) {
-                        strm<<"IDLE     sid="<<chan->sid<<" cid="<<chan->cid<<"\n";
-                    }
+                        if(chan->state==ServerChan::Creating) {
+                            strm<<"CREATING sid="<<chan->sid<<" cid="<<chan->cid<<"\n";
+                        } else if(chan->state==ServerChan::Destroy) {
+                            strm<<"DESTROY  sid="<<chan->sid<<" cid="<<chan->cid<<"\n";
+                        } else if(chan->opByIOID.empty()) {
+                            strm<<"IDLE     sid="<<chan->sid<<" cid="<<chan->cid<<"\n";
+                        }
 
-                    for(auto& pair : chan->opByIOID) {
-                        auto& op = pair.second;
-                        if(!op) {
-                            strm<<"NULL ioid="<<pair.first<<"\n";
-                        } else {
-                            strm<<indent{};
-                            switch (op->state) {
+                        for(auto& pair : chan->opByIOID) {
+                            auto& op = pair.second;
+                            if(!op) {
+                                strm<<"NULL ioid="<<pair.first<<"\n";
+                            } else {
+                                strm<<indent{};
+                                switch (op->state) {
 #define CASE(STATE) case ServerOp::STATE: strm<< #STATE; break
-                            CASE(Creating);
-                            CASE(Idle);
-                            CASE(Executing);
-                            CASE(Dead);
+                                CASE(Creating);
+                                CASE(Idle);
+                                CASE(Executing);
+                                CASE(Dead);
 #undef CASE
+                                }
+                                strm<<" ioid="<<pair.first<<" ";
+                                op->show(strm);
                             }
-                            strm<<" ioid="<<pair.first<<" ";
-                            op->show(strm);
                         }
                     }
                 }
-            }
-        });
+            }, w.get());
+        }
     }
 
     return strm;
@@ -388,6 +579,7 @@ Server::Pvt::Pvt(const Config &conf)
                  event_new(acceptor_loop.base, -1, EV_TIMEOUT, doBeaconsS, this))
     ,searchReply(0x10000)
     ,builtinsrc(StaticSource::build())
+    ,memory(std::make_shared<MemBudget>())
     ,state(Stopped)
 {
     effective.expand();
@@ -482,6 +674,22 @@ Server::Pvt::Pvt(const Config &conf)
         log_err_printf(serversetup, "Server Unreachable.  Interface address list includes not TCP interfaces.%s", "\n");
     }
 
+    workers.reserve(effective.tcpWorkers);
+    for(auto i : range(effective.tcpWorkers)) {
+        if(i==0u) {
+            workers.emplace_back(new ServerWorker(i, acceptor_loop));
+        } else {
+            evbase loop(SB()<<"PVXTCP"<<i, epicsThreadPriorityCAServerLow-2);
+            workers.emplace_back(new ServerWorker(i, loop));
+        }
+    }
+
+    handlers.reserve(effective.handlerWorkers);
+    for(auto i : range(effective.handlerWorkers)) {
+        evbase loop(SB()<<"PVXHDL"<<i, epicsThreadPriorityCAServerLow-2);
+        handlers.emplace_back(new HandlerWorker(i, loop));
+    }
+
     ignoreList.reserve(effective.ignoreAddrs.size());
     for(const auto& addr : effective.ignoreAddrs) {
         SockAddr temp(addr.c_str());
@@ -560,6 +768,7 @@ Server::Pvt::Pvt(const Config &conf)
         auto L = sourcesLock.lockWriter();
         sources[std::make_pair(-1, "__server")] = std::make_shared<ServerSource>(this);
         sources[std::make_pair(-1, "__builtin")] = builtinsrc.source();
+        updateSearchPlan();
     }
 }
 
@@ -650,13 +859,24 @@ void Server::Pvt::stop()
             log_debug_printf(serversetup, "Server disabled listener on %s\n", iface.name.c_str());
         }
 
-        // close current TCP connections
-        auto conns = std::move(connections);
-        for(auto& pair : conns) {
-            pair.second->disconnect();
-            pair.second->cleanup();
-        }
+    });
+
+    // close current TCP connections.
+    // Any connections handed off before the listeners were disabled are already queued.
+    for(auto& worker : workers) {
+        worker->loop.call([&worker]()
+        {
+            auto conns = std::move(worker->connections);
+            worker->nconn -= conns.size();
+            for(auto& pair : conns) {
+                pair.second->disconnect();
+                pair.second->cleanup();
+            }
+        });
+    }
 
+    acceptor_loop.call([this]()
+    {
         state = Stopped;
     });
 
@@ -664,9 +884,122 @@ void Server::Pvt::stop()
      * TODO: this is partly a crutch as eg. SharedPV::attach() binds strong self references
      *       into on*() lambdas, which indirectly hold references keeping acceptor_loop alive.
      */
+    for(auto& worker : workers) {
+        worker->loop.sync();
+    }
+    for(auto& handler : handlers) {
+        handler->loop.sync();
+    }
     acceptor_loop.sync();
 }
 
+ServerWorker* Server::Pvt::pickWorker()
+{
+    acceptor_loop.assertInLoop();
+
+    // least loaded, with ties broken round robin
+    auto nworkers = workers.size();
+    auto best = workers[nextWorker % nworkers].get();
+    for(auto i : range(size_t(1u), nworkers)) {
+        auto cand = workers[(nextWorker + i) % nworkers].get();
+        if(cand->nconn < best->nconn)
+            best = cand;
+    }
+    nextWorker = (best->index + 1u) % nworkers;
+
+    best->nconn++;
+    best->naccepted++;
+    return best;
+}
+
+void Server::Pvt::updateSearchPlan()
+{
+    auto plan(std::make_shared<SearchPlan>());
+    for(const auto& pair : sources) {
+        if(auto idx = dynamic_cast<SearchIndexed*>(pair.second.get())) {
+            plan->indexed.emplace_back(pair.second, idx);
+        } else {
+            plan->opaque.emplace_back(pair.first.second, pair.second);
+        }
+    }
+
+    Guard G(searchPlanLock);
+    searchPlan = std::move(plan);
+}
+
+void Server::Pvt::doSearch(Source::Search& op)
+{
+    std::shared_ptr<const SearchPlan> plan;
+    {
+        Guard G(searchPlanLock);
+        plan = searchPlan;
+    }
+
+    // answer from name indices first.  No Source code or RWLock involved.
+    size_t nremain = op._names.size();
+    {
+        std::string key;
+        for(size_t i=0u; nremain && i<plan->indexed.size(); i++) {
+            auto names(plan->indexed[i].second->searchNames());
+            if(!names || names->empty())
+                continue;
+
+            for(auto& name : op._names) {
+                if(name._claim)
+                    continue;
+                key.assign(name._name);
+                if(names->find(key)!=names->end()) {
+                    name._claim = true;
+                    nremain--;
+                }
+            }
+        }
+    }
+
+    if(!nremain || plan->opaque.empty())
+        return;
+
+    // offer any remaining names to the other Sources
+    Source::Search sub;
+    std::vector<size_t> subIdx;
+    const bool partial = nremain!=op._names.size();
+    if(partial) {
+        memcpy(sub._src, op._src, sizeof(sub._src));
+        sub._names.reserve(nremain);
+        subIdx.reserve(nremain);
+        for(auto i : range(op._names.size())) {
+            if(!op._names[i]._claim) {
+                sub._names.push_back(op._names[i]);
+                subIdx.push_back(i);
+            }
+        }
+    }
+    auto& target = partial ? sub : op;
+
+    {
+        // re-fetch under sourcesLock so that removeSource() is synchronous wrt. onSearch()
+        auto G(sourcesLock.lockReader());
+        {
+            Guard P(searchPlanLock);
+            plan = searchPlan;
+        }
+        for(const auto& pair : plan->opaque) {
+            try {
+                pair.second->onSearch(target);
+            }catch(std::exception& e){
+                log_exc_printf(serversearch, "Unhandled error in Source::onSearch for '%s' : %s\n",
+                           pair.first.c_str(), e.what());
+            }
+        }
+    }
+
+    if(partial) {
+        for(auto i : range(subIdx.size())) {
+            op._names[subIdx[i]]._claim |= sub._names[i]._claim;
+        }
+    }
+}
+
 void Server::Pvt::onSearch(const UDPManager::Search& msg)
 {
     // on UDPManager worker
@@ -694,17 +1027,7 @@ void Server::Pvt::onSearch(const UDPManager::Search& msg)
     }
     ipAddrToDottedIP(&msg.server->in, searchOp._src, sizeof(searchOp._src));
 
-    {
-        auto G(sourcesLock.lockReader());
-        for(const auto& pair : sources) {
-            try {
-                pair.second->onSearch(searchOp);
-            }catch(std::exception& e){
-                log_exc_printf(serversetup, "Unhandled error in Source::onSearch for '%s' : %s\n",
-                           pair.first.second.c_str(), e.what());
-            }
-        }
-    }
+    doSearch(searchOp);
 
     uint16_t nreply = 0;
     for(const auto& name : searchOp._names) {
@@ -6,6 +6,7 @@
 
 #include <stdexcept>
 #include <cassert>
+#include <functional>
 
 #include "pvxs/log.h"
 #include "serverconn.h"
@@ -62,6 +63,7 @@ void ServerChan::cleanup()
 ServerChannelControl::ServerChannelControl(const std::shared_ptr<ServerConn> &conn, const std::shared_ptr<ServerChan>& channel)
     :server::ChannelControl(channel->name, conn->cred, None)
     ,server(conn->iface->server->internal_self)
+    ,loop(conn->worker->loop.internal())
     ,chan(channel)
 {}
 
@@ -73,13 +75,14 @@ void ServerChannelControl::onOp(std::function<void(std::unique_ptr<server::Conne
     if(!serv)
         return;
 
-    serv->acceptor_loop.call([this, &fn](){
+    loop.post(std::bind([](const std::weak_ptr<ServerChan>& chan,
+                           std::function<void(std::unique_ptr<server::ConnectOp>&&)>& fn){
         auto ch = chan.lock();
         if(!ch)
             return;
 
         ch->onOp = std::move(fn);
-    });
+    }, chan, std::move(fn)));
 }
 
 void ServerChannelControl::onRPC(std::function<void(std::unique_ptr<server::ExecOp>&&, Value&&)>&& fn)
@@ -88,13 +91,14 @@ void ServerChannelControl::onRPC(std::function<void(std::unique_ptr<server::Exec
     if(!serv)
         return;
 
-    serv->acceptor_loop.call([this, &fn](){
+    loop.post(std::bind([](const std::weak_ptr<ServerChan>& chan,
+                           std::function<void(std::unique_ptr<server::ExecOp>&&, Value&&)>& fn){
         auto ch = chan.lock();
         if(!ch)
             return;
 
         ch->onRPC = std::move(fn);
-    });
+    }, chan, std::move(fn)));
 }
 
 void ServerChannelControl::onSubscribe(std::function<void(std::unique_ptr<server::MonitorSetupOp>&&)>&& fn)
@@ -103,13 +107,14 @@ void ServerChannelControl::onSubscribe(std::function<void(std::unique_ptr<server
     if(!serv)
         return;
 
-    serv->acceptor_loop.call([this, &fn](){
+    loop.post(std::bind([](const std::weak_ptr<ServerChan>& chan,
+                           std::function<void(std::unique_ptr<server::MonitorSetupOp>&&)>& fn){
         auto ch = chan.lock();
         if(!ch)
             return;
 
         ch->onSubscribe = std::move(fn);
-    });
+    }, chan, std::move(fn)));
 }
 
 void ServerChannelControl::onClose(std::function<void(const std::string&)>&& fn)
@@ -118,13 +123,14 @@ void ServerChannelControl::onClose(std::function<void(const std::string&)>&& fn)
     if(!serv)
         return;
 
-    serv->acceptor_loop.call([this, &fn](){
+    loop.post(std::bind([](const std::weak_ptr<ServerChan>& chan,
+                           std::function<void(const std::string&)>& fn){
         auto ch = chan.lock();
         if(!ch || ch->state==ServerChan::Destroy)
             return;
 
         ch->onClose = std::move(fn);
-    });
+    }, chan, std::move(fn)));
 }
 
 void ServerChannelControl::close()
@@ -134,7 +140,7 @@ void ServerChannelControl::close()
     if(!serv)
         return;
 
-    serv->acceptor_loop.call([this](){
+    auto fn(std::bind([](const std::weak_ptr<ServerChan>& chan){
         auto ch = chan.lock();
         if(!ch)
             return;
@@ -153,7 +159,15 @@ void ServerChannelControl::close()
         }
 
         ch->cleanup();
-    });
+    }, chan));
+
+    if(!loop.inLoop() && serv->currentWorker()) {
+        // from another TCP worker.  Waiting could deadlock if that worker is concurrently
+        // waiting on us.  eg. SharedPV::close() from handlers on both.
+        loop.dispatch(std::move(fn));
+    } else {
+        loop.call(std::move(fn));
+    }
 }
 
 void ServerChannelControl::_updateInfo(const std::shared_ptr<const ReportInfo>& info)
@@ -162,7 +176,8 @@ void ServerChannelControl::_updateInfo(const std::shared_ptr<const ReportInfo>&
     if(!serv)
         return;
 
-    serv->acceptor_loop.call([this, &info](){
+    auto chan(this->chan);
+    loop.post([chan, info](){
         auto ch = chan.lock();
         if(!ch)
             return;
@@ -209,17 +224,7 @@ void ServerConn::handle_SEARCH()
     if(!M.good())
         throw std::runtime_error(SB()<<M.file()<<':'<<M.line()<<" TCP Search decode error");
 
-    {
-        auto G(iface->server->sourcesLock.lockReader());
-        for(const auto& pair : iface->server->sources) {
-            try {
-                pair.second->onSearch(op);
-            }catch(std::exception& e){
-                log_exc_printf(serversearch, "Unhandled error in Source::onSearch for '%s' : %s\n",
-                           pair.first.second.c_str(), e.what());
-            }
-        }
-    }
+    iface->server->doSearch(op);
 
     uint16_t nreply = 0;
     for(const auto& name : op._names) {
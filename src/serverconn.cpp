@@ -53,11 +53,23 @@ DEFINE_LOGGER(connio, "pvxs.tcp.io");
 
 DEFINE_LOGGER(remote, "pvxs.remote.log");
 
-ServerConn::ServerConn(ServIface* iface, evutil_socket_t sock, struct sockaddr *peer, int socklen)
+void ServerWorker::runCollect()
+{
+    decltype(collecting) todo;
+    {
+        epicsGuard<epicsMutex> G(collectLock);
+        todo.swap(collecting);
+    }
+    for(auto& fn : todo)
+        fn();
+}
+
+ServerConn::ServerConn(ServIface* iface, ServerWorker *worker, evutil_socket_t sock, const SockAddr& peer)
     :ConnBase(false, iface->server->effective.sendBE(),
-              bufferevent_socket_new(iface->server->acceptor_loop.base, sock, BEV_OPT_CLOSE_ON_FREE|BEV_OPT_DEFER_CALLBACKS),
-              SockAddr(peer))
+              bufferevent_socket_new(worker->loop.base, sock, BEV_OPT_CLOSE_ON_FREE|BEV_OPT_DEFER_CALLBACKS),
+              peer)
     ,iface(iface)
+    ,worker(worker)
     ,tcp_tx_limit(evsocket::get_buffer_size(sock, true) * tcp_tx_limit_mult)
 {
     log_debug_printf(connio, "Client %s connects, RX readahead %zu TX limit %zu\n",
@@ -79,11 +91,23 @@ ServerConn::ServerConn(ServIface* iface, evutil_socket_t sock, struct sockaddr *
         this->cred = std::move(cred);
     }
 
+    if(iface->server->effective.memoryBudget)
+        memory = std::make_shared<MemBudget>(iface->server->memory);
+
     bufferevent_setcb(bev.get(), &bevReadS, &bevWriteS, &bevEventS, this);
 
     timeval tmo(totv(iface->server->effective.tcpTimeout));
     bufferevent_set_timeouts(bev.get(), &tmo, &tmo);
 
+    txRegistry.limit = iface->server->effective.txTypeCache;
+
+    if(iface->server->effective.txCoalesceDelay>0.0) {
+        txCoalesceDelay = iface->server->effective.txCoalesceDelay;
+        txCoalesceBytes = iface->server->effective.txCoalesceBytes;
+        txCoalesceTimer = evevent(__FILE__, __LINE__,
+                                  event_new(worker->loop.base, -1, EV_TIMEOUT, &txCoalesceS, this));
+    }
+
     auto tx = bufferevent_get_output(bev.get());
 
     std::vector<uint8_t> buf(128);
@@ -347,7 +371,8 @@ void ServerConn::cleanup()
 {
     log_debug_printf(connsetup, "Client %s Cleanup TCP Connection\n", peerName.c_str());
 
-    iface->server->connections.erase(this);
+    if(worker->connections.erase(this))
+        worker->nconn--;
 
     // grab maps before cleanup()s would modify
     auto ops(std::move(opByIOID));
@@ -359,6 +384,9 @@ void ServerConn::cleanup()
     for(auto& pair : chans) {
         pair.second->cleanup();
     }
+
+    if(!bev)
+        releaseTxMemory();
 }
 
 void ServerConn::bevRead()
@@ -386,7 +414,8 @@ void ServerConn::bevWrite()
     // handle pending monitors
 
     while(!backlog.empty() && evbuffer_get_length(tx)<tcp_tx_limit) {
-        auto fn = std::move(backlog.front());
+        statBacklog.record(epicsMonotonicGet() - backlog.front().first);
+        auto fn = std::move(backlog.front().second);
         backlog.pop_front();
 
         fn();
@@ -456,11 +485,34 @@ void ServIface::onConnS(struct evconnlistener *listener, evutil_socket_t sock, s
 {
     auto self = static_cast<ServIface*>(raw);
     try {
-        auto conn(std::make_shared<ServerConn>(self, sock, peer, socklen));
-        self->server->connections[conn.get()] = std::move(conn);
+        SockAddr addr(peer, socklen);
+        auto worker = self->server->pickWorker();
+
+        if(worker->loop.base==self->server->acceptor_loop.base) {
+            newConn(self, worker, sock, addr);
+
+        } else if(!worker->loop.tryDispatch([self, worker, sock, addr](){
+                      newConn(self, worker, sock, addr);
+                  })) {
+            worker->nconn--;
+            evutil_closesocket(sock);
+        }
+    }catch(std::exception& e){
+        log_exc_printf(connsetup, "Interface %s Unhandled error in accept callback: %s\n", self->name.c_str(), e.what());
+        evutil_closesocket(sock);
+    }
+}
+
+// on worker
+void ServIface::newConn(ServIface* self, ServerWorker* worker, evutil_socket_t sock, const SockAddr& peer)
+{
+    try {
+        auto conn(std::make_shared<ServerConn>(self, worker, sock, peer));
+        worker->connections[conn.get()] = std::move(conn);
     }catch(std::exception& e){
         log_exc_printf(connsetup, "Interface %s Unhandled error in accept callback: %s\n", self->name.c_str(), e.what());
         evutil_closesocket(sock);
+        worker->nconn--;
     }
 }
 
@@ -501,7 +553,7 @@ void ServerOp::cleanup()
             conn->opByIOID.erase(ioid);
 
             if(notify) {
-                conn->iface->server->acceptor_loop.dispatch([closer](){
+                conn->worker->loop.dispatch([closer](){
                     closer("");
                 });
                 notify = false;
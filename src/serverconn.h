@@ -10,9 +10,14 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
 #include <atomic>
+#include <functional>
 
 #include <epicsEvent.h>
+#include <epicsMutex.h>
 
 #include <pvxs/server.h>
 #include <pvxs/source.h>
@@ -22,10 +27,12 @@
 #include "dataimpl.h"
 #include "udp_collector.h"
 #include "conn.h"
+#include "pvrequest.h"
 
 namespace pvxs {namespace impl {
 
 struct ServIface;
+struct ServerWorker;
 struct ServerConn;
 struct ServerChan;
 
@@ -72,6 +79,8 @@ struct ServerChannelControl : public server::ChannelControl
     virtual void _updateInfo(const std::shared_ptr<const ReportInfo>& info) override final;
 
     const std::weak_ptr<server::Server::Pvt> server;
+    // worker owning the connection of this channel
+    const evbase loop;
     const std::weak_ptr<ServerChan> chan;
 
     INST_COUNTER(ServerChannelControl);
@@ -91,6 +100,8 @@ struct ServerChan
     } state;
 
     size_t statTx{}, statRx{};
+    // time from post() until a monitor update is encoded.  allocated with first update.
+    std::unique_ptr<LatencyHist> statPostEncode;
     std::shared_ptr<const ReportInfo> reportInfo;
 
     std::function<void(std::unique_ptr<server::ConnectOp>&&)> onOp;
@@ -113,6 +124,7 @@ struct ServerChan
 struct ServerConn final : public ConnBase, public std::enable_shared_from_this<ServerConn>
 {
     ServIface* const iface;
+    ServerWorker* const worker;
     const size_t tcp_tx_limit;
 
     std::shared_ptr<const server::ClientCredentials> cred;
@@ -121,11 +133,15 @@ struct ServerConn final : public ConnBase, public std::enable_shared_from_this<S
     std::map<uint32_t, std::shared_ptr<ServerChan> > chanBySID;
     std::map<uint32_t, std::shared_ptr<ServerOp> > opByIOID;
 
-    std::list<std::function<void()>> backlog;
+    // replies deferred while TX buffer is full, with time queued
+    std::list<std::pair<epicsUInt64, std::function<void()>>> backlog;
+
+    // time from post() until a monitor update is encoded, and time spent in backlog
+    LatencyHist statPostEncode, statBacklog;
 
     INST_COUNTER(ServerConn);
 
-    ServerConn(ServIface* iface, evutil_socket_t sock, struct sockaddr *peer, int socklen);
+    ServerConn(ServIface* iface, ServerWorker* worker, evutil_socket_t sock, const SockAddr& peer);
     ServerConn(const ServerConn&) = delete;
     ServerConn& operator=(const ServerConn&) = delete;
     ~ServerConn();
@@ -178,16 +194,131 @@ struct ServIface
     ServIface(const SockAddr &addr, server::Server::Pvt *server, bool fallback);
 
     static void onConnS(struct evconnlistener *listener, evutil_socket_t sock, struct sockaddr *peer, int socklen, void *raw);
+    static void newConn(ServIface* self, ServerWorker* worker, evutil_socket_t sock, const SockAddr& peer);
+};
+
+// One of Server::Pvt::workers.  Services a subset of the TCP connections.
+struct ServerWorker
+{
+    const size_t index;
+
+    // handles I/O and operations for our connections.
+    // The first worker shares Server::Pvt::acceptor_loop
+    const evbase loop;
+
+    // only accessed from loop
+    std::map<ServerConn*, std::shared_ptr<ServerConn> > connections;
+
+    // connections assigned, and not yet closed.
+    // incremented by acceptor, decremented from loop
+    std::atomic<size_t> nconn{0u};
+    // total connections assigned
+    std::atomic<size_t> naccepted{0u};
+
+    // cf. Server::Pvt::collect().  Requests queued for this worker.
+    // Run from loop, or by the loop thread while it waits in collect().
+    epicsMutex collectLock;
+    std::vector<std::function<void()>> collecting;
+    // signaled when collecting is appended to, or when a collect() from loop completes.
+    epicsEvent collectWake;
+
+    ServerWorker(size_t index, const evbase& loop) :index(index), loop(loop) {}
+
+    // on loop.  Run queued collect() requests
+    void runCollect();
+    ServerWorker(const ServerWorker&) = delete;
+    ServerWorker& operator=(const ServerWorker&) = delete;
 };
 
 
+// One of Server::Pvt::handlers.  Runs Source onGet/onPut/onRPC handlers off of the TCP workers.
+struct HandlerWorker
+{
+    const size_t index;
+    const evbase loop;
+
+    // calls dispatched and not yet started.  incremented by TCP workers, decremented from loop
+    std::atomic<size_t> queued{0u};
+
+    // guards further members.  updated from loop, read by Server::Pvt::report()
+    epicsMutex lock;
+    size_t maxQueued = 0u;
+    LatencyHist wait, service;
+
+    HandlerWorker(size_t index, const evbase& loop) :index(index), loop(loop) {}
+    HandlerWorker(const HandlerWorker&) = delete;
+    HandlerWorker& operator=(const HandlerWorker&) = delete;
+};
+
+/* Shares the serialized form of a monitor update among subscriptions
+ * which are posted the same Value with identical pvRequest masks.
+ * eg. SharedPV::post() fanning out to many clients.
+ * Only consulted when the posted Value is referenced elsewhere,
+ * and split into shards by storage address to limit contention.
+ * Relies on the rule that a Value must not be modified after post().
+ * cf. servermon.cpp
+ */
+struct UpdateCache
+{
+    struct Entry {
+        // also keeps storage alive, so the lookup address can't be re-used
+        const Value val;
+        BitMask mask;
+        const bool be;
+
+        // guards further members
+        epicsMutex lock;
+        bool encoded = false;
+        // BitMask, valid fields, and overrun mask.
+        // Not modified once encoded.  May reference large arrays of val.
+        evbuf body;
+        // with Config::memoryBudget, storage of val charged to the server total.
+        // Shared with other entries for the same val.
+        std::shared_ptr<MemCharge> charge;
+
+        INST_COUNTER(UpdateCacheEntry);
+
+        Entry(const Value& val, const BitMask& mask, bool be);
+    };
+
+    struct Shard {
+        epicsMutex lock;
+        // Entries are owned by MonitorOp queues, and expire after being sent to every subscriber
+        std::multimap<const FieldStorage*, std::weak_ptr<Entry> > entries;
+        // purge expired entries when size() reaches this
+        size_t purgeAt = 16u;
+    };
+    static constexpr size_t nShards = 16u;
+    Shard shards[nShards];
+
+    // returns NULL if val is not shared, and so not worth caching.
+    // When budget is not NULL, a new entry charges it for the storage of val.
+    std::shared_ptr<Entry> lookup(const Value& val, const BitMask& mask, bool be,
+                                  const std::shared_ptr<MemBudget>& budget);
+};
+
+/** Optional interface for a Source whose claimable names can be snapshotted.
+ *
+ *  Server::Pvt answers searches for such Sources by probing searchNames()
+ *  instead of calling Source::onSearch().
+ */
+struct SearchIndexed
+{
+    typedef std::unordered_set<std::string> names_t;
+
+    virtual ~SearchIndexed();
+    //! Current set of names which onSearch() would claim.  Must be cheap in the steady state.
+    virtual std::shared_ptr<const names_t> searchNames() =0;
+};
+
 //! Home of the magic "server" PV used by "pvinfo"
-struct ServerSource : public server::Source
+struct ServerSource : public server::Source, public SearchIndexed
 {
     const std::string name;
     server::Server::Pvt* const serv;
 
     const Value info;
+    const Value latency;
 
     INST_COUNTER(ServerSource);
 
@@ -196,6 +327,8 @@ struct ServerSource : public server::Source
     virtual void onSearch(Search &op) override final;
 
     virtual void onCreate(std::unique_ptr<server::ChannelControl> &&op) override final;
+
+    virtual std::shared_ptr<const names_t> searchNames() override final;
 };
 
 } // namespace impl
@@ -223,12 +356,18 @@ struct Server::Pvt
     // accept new connections and send beacons
     evbase acceptor_loop;
 
+    // Config::tcpWorkers entries.  acceptor assigns each new connection to one of these.
+    std::vector<std::unique_ptr<ServerWorker> > workers;
+    // round robin starting point when choosing a worker.  only accessed from acceptor
+    size_t nextWorker = 0u;
+    // Config::handlerWorkers entries.  Empty when handlers run on the TCP workers.
+    std::vector<std::unique_ptr<HandlerWorker> > handlers;
+
     std::list<std::unique_ptr<UDPListener> > listeners;
     std::vector<SockEndpoint> beaconDest;
     std::vector<SockAddr> ignoreList;
 
     std::list<ServIface> interfaces;
-    std::map<ServerConn*, std::shared_ptr<ServerConn> > connections;
 
     evsocket beaconSender4, beaconSender6;
     evevent beaconTimer;
@@ -244,6 +383,24 @@ struct Server::Pvt
     RWLock sourcesLock;
     std::map<std::pair<int, std::string>, std::shared_ptr<Source> > sources;
 
+    // snapshot of 'sources' split by search strategy.  rebuilt whenever 'sources' changes.
+    struct SearchPlan {
+        // Sources answered from SearchIndexed::searchNames()
+        std::vector<std::pair<std::shared_ptr<Source>, SearchIndexed*> > indexed;
+        // Sources which must be asked through Source::onSearch()
+        std::vector<std::pair<std::string, std::shared_ptr<Source> > > opaque;
+    };
+    epicsMutex searchPlanLock;
+    std::shared_ptr<const SearchPlan> searchPlan;
+
+    UpdateCache updateCache;
+
+    RequestPlanCache requestPlans;
+
+    // total of bytes held for clients.  cf. Config::memoryBudget
+    const std::shared_ptr<MemBudget> memory;
+    std::atomic<bool> memoryCheckPending{false};
+
     enum state_t {
         Stopped,
         Starting,
@@ -259,6 +416,46 @@ struct Server::Pvt
     void start();
     void stop();
 
+    // cf. Server::report().  may call from any thread, including a TCP worker
+    Report report(bool zero);
+
+    // Run fn on the loop of each worker, or only one when non-NULL, and wait for completion.
+    // When called from a worker, that worker runs its own, and any other queued requests, while waiting.
+    // So concurrent collect() from different workers can not deadlock.
+    // fn must not block.
+    void collect(const std::function<void(ServerWorker&)>& fn, ServerWorker* only=nullptr);
+
+    // call from acceptor
+    ServerWorker* pickWorker();
+
+    // the worker whose loop is running on the calling thread, or nullptr
+    ServerWorker* currentWorker() const {
+        for(auto& worker : workers) {
+            if(worker->loop.inLoop())
+                return worker.get();
+        }
+        return nullptr;
+    }
+
+    // handler thread for PV name, or nullptr when handlers run on the TCP worker.  may call from any thread
+    HandlerWorker* pickHandler(const std::string& name) const {
+        if(handlers.empty())
+            return nullptr;
+        return handlers[std::hash<std::string>{}(name) % handlers.size()].get();
+    }
+
+    // is Config::memoryBudget exceeded?  may call from any thread
+    bool overBudget() const {
+        return effective.memoryBudget && memory->held.load(std::memory_order_relaxed) >= effective.memoryBudget;
+    }
+    // disconnect client for which the most memory is held, if still over budget.  may call from any thread
+    void enforceBudget();
+
+    // call with sourcesLock held for write
+    void updateSearchPlan();
+    // fill in Search::Name::_claim.  called from UDP and TCP workers
+    void doSearch(Source::Search& op);
+
 private:
     void onSearch(const UDPManager::Search& msg);
     void doBeacons(short evt);
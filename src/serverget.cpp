@@ -5,6 +5,9 @@
  */
 
 #include <cassert>
+#include <functional>
+
+#include <epicsGuard.h>
 
 #include <pvxs/log.h>
 #include "dataimpl.h"
@@ -15,6 +18,8 @@ namespace pvxs { namespace impl {
 DEFINE_LOGGER(connsetup, "pvxs.tcp.setup");
 DEFINE_LOGGER(connio, "pvxs.tcp.io");
 
+typedef epicsGuard<epicsMutex> Guard;
+
 namespace {
 server::OpBase::op_t
 cmd2op(pva_app_msg_t cmd){
@@ -79,6 +84,7 @@ struct ServerGPR final : public ServerOp
             (void)evbuffer_drain(conn->txBody.get(), evbuffer_get_length(conn->txBody.get()));
 
             EvOutBuf R(conn->sendBE, conn->txBody.get());
+            R.refThreshold = conn->iface->server->effective.zeroCopyThreshold;
             to_wire(R, uint32_t(ioid));
             to_wire(R, subcmd);
             to_wire(R, sts);
@@ -94,17 +100,17 @@ struct ServerGPR final : public ServerOp
             } else if(state==Creating) {
                 // connect()
                 if(cmd!=CMD_RPC) {
-                    to_wire(R, type.get());
+                    to_wire(R, type.get(), conn->txRegistry);
                 }
                 state = Idle;
 
             } else if(state==Executing) {
                 if(cmd==CMD_GET || (cmd==CMD_PUT && (subcmd&0x40))) {
-                    to_wire_valid(R, value, &pvMask); // GET and PUT/Get reply with bitmask and partial value
+                    to_wire_valid(R, value, &plan->mask); // GET and PUT/Get reply with bitmask and partial value
 
                 } else if(cmd==CMD_RPC) {
                     auto type = Value::Helper::desc(value);
-                    to_wire(R, type);
+                    to_wire(R, type, conn->txRegistry);
                     if(value)
                         to_wire_full(R, value);
                 }
@@ -151,7 +157,8 @@ struct ServerGPR final : public ServerOp
 
     std::shared_ptr<const FieldDesc> type;
     Value pvRequest;
-    BitMask pvMask; // mask computed from pvRequest .fields
+    // computed from pvRequest .fields.  shared through Server::Pvt::requestPlans
+    std::shared_ptr<const RequestPlan> plan;
 
     std::function<void(std::unique_ptr<server::ExecOp>&&, Value&&)> onPut;
 
@@ -172,6 +179,7 @@ struct ServerGPRConnect : public server::ConnectOp
                      const std::weak_ptr<ServerGPR>& op)
         :server::ConnectOp(name, conn->cred, cmd2op(cmd), request)
         ,server(server)
+        ,loop(conn->worker->loop.internal())
         ,op(op)
     {}
     virtual ~ServerGPRConnect() {
@@ -180,28 +188,36 @@ struct ServerGPRConnect : public server::ConnectOp
 
     virtual void connect(const Value& prototype) override final
     {
+        if(!prototype && _op!=RPC)
+            throw std::invalid_argument("Must provide prototype");
+
+        if(connected)
+            throw std::logic_error("Operation already connected (has a type)");
+        connected = true;
+
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &prototype](){
+
+        std::shared_ptr<const FieldDesc> type;
+        std::shared_ptr<const RequestPlan> plan;
+        if(prototype) {
+            type = Value::Helper::type(prototype);
+            plan = serv->requestPlans.lookup(type, _pvRequest);
+        }
+
+        auto op(this->op);
+        loop.post(std::bind([op](std::shared_ptr<const FieldDesc>& type, std::shared_ptr<const RequestPlan>& plan){
             if(auto oper = op.lock()) {
                 if(oper->state!=ServerOp::Creating)
                     return;
 
-                if(!prototype && oper->cmd!=CMD_RPC)
-                    throw std::invalid_argument("Must provide prototype");
-
-                if(oper->type)
-                    throw std::logic_error("Operation already connected (has a type)");
-
-                if(prototype) {
-                    oper->type = Value::Helper::type(prototype);
-                    oper->pvMask = request2mask(oper->type.get(), _pvRequest);
-                }
+                oper->type = std::move(type);
+                oper->plan = std::move(plan);
 
                 oper->doReply(Value(), std::string());
             }
-        });
+        }, std::move(type), std::move(plan)));
     }
     virtual void error(const std::string& msg) override final
     {
@@ -211,7 +227,7 @@ struct ServerGPRConnect : public server::ConnectOp
         if(!serv)
             return;
         auto op(this->op);
-        serv->acceptor_loop.dispatch([op, msg](){
+        loop.dispatch([op, msg](){
             if(auto oper = op.lock()) {
                 if(oper->state==ServerOp::Creating)
                     oper->doReply(Value(), msg);
@@ -224,34 +240,40 @@ struct ServerGPRConnect : public server::ConnectOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.post(std::bind([](const std::weak_ptr<ServerGPR>& op,
+                               std::function<void(std::unique_ptr<server::ExecOp>&&)>& fn){
             if(auto oper = op.lock())
                 oper->onGet = std::move(fn);
-        });
+        }, op, std::move(fn)));
     }
     virtual void onPut(std::function<void(std::unique_ptr<server::ExecOp>&&, Value&&)>&& fn) override final
     {
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.post(std::bind([](const std::weak_ptr<ServerGPR>& op,
+                               std::function<void(std::unique_ptr<server::ExecOp>&&, Value&&)>& fn){
             if(auto oper = op.lock())
                 oper->onPut = std::move(fn);
-        });
+        }, op, std::move(fn)));
     }
     virtual void onClose(std::function<void(const std::string&)>&& fn) override final
     {
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.post(std::bind([](const std::weak_ptr<ServerGPR>& op,
+                               std::function<void(const std::string&)>& fn){
             if(auto oper = op.lock())
                 oper->onClose = std::move(fn);
-        });
+        }, op, std::move(fn)));
     }
 
     const std::weak_ptr<server::Server::Pvt> server;
+    const evbase loop;
     const std::weak_ptr<ServerGPR> op;
+    // connect() called.  only accessed by the owner of this ConnectOp
+    bool connected = false;
 
     INST_COUNTER(ServerGPRConnect);
 };
@@ -267,6 +289,7 @@ struct ServerGPRExec : public server::ExecOp
                   const std::shared_ptr<ServerGPR>& op)
         :server::ExecOp(name, conn->cred, cmd2op(cmd), op->pvRequest)
         ,server(server)
+        ,loop(conn->worker->loop.internal())
         ,op(op)
     {}
     virtual ~ServerGPRExec() {}
@@ -282,7 +305,7 @@ struct ServerGPRExec : public server::ExecOp
         if(!serv)
             return;
         auto op(this->op);
-        serv->acceptor_loop.dispatch([op, val](){
+        loop.dispatch([op, val](){
             if(auto oper = op.lock()) {
                 oper->doReply(val, std::string());
             }
@@ -297,7 +320,7 @@ struct ServerGPRExec : public server::ExecOp
         if(!serv)
             return;
         auto op(this->op);
-        serv->acceptor_loop.dispatch([op, msg](){
+        loop.dispatch([op, msg](){
             if(auto oper = op.lock()) {
                 oper->doReply(Value(), msg);
             }
@@ -309,10 +332,11 @@ struct ServerGPRExec : public server::ExecOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.post(std::bind([](const std::weak_ptr<ServerGPR>& op,
+                               std::function<void()>& fn){
             if(auto oper = op.lock())
                 oper->onCancel = std::move(fn);
-        });
+        }, op, std::move(fn)));
     }
 
     virtual Timer _timerOneShot(double delay, std::function<void()>&& fn) override final
@@ -321,16 +345,65 @@ struct ServerGPRExec : public server::ExecOp
         if(!serv)
             throw std::logic_error("Can't start timer on deal server");
 
-        return Timer::Pvt::buildOneShot(delay, serv->acceptor_loop.internal(), std::move(fn));
+        return Timer::Pvt::buildOneShot(delay, loop, std::move(fn));
     }
 
     const std::weak_ptr<server::Server::Pvt> server;
+    const evbase loop;
     const std::weak_ptr<ServerGPR> op;
 
     INST_COUNTER(ServerGPRExec);
 };
 DEFINE_INST_COUNTER(ServerGPRExec);
 
+typedef std::function<void(std::unique_ptr<server::ExecOp>&&, Value&&)> onPutRPC_t;
+typedef std::function<void(std::unique_ptr<server::ExecOp>&&)> onGet_t;
+
+// call user onGet(), or onPut()/onRPC()
+void runHandler(const std::string& peerName,
+                std::unique_ptr<server::ExecOp>& ctrl,
+                Value& val,
+                const onGet_t* onGet,
+                const onPutRPC_t* onPutRPC)
+{
+    try {
+        if(onGet)
+            (*onGet)(std::move(ctrl));
+        else
+            (*onPutRPC)(std::move(ctrl), std::move(val));
+    } catch(std::exception& e) {
+        log_err_printf(connsetup, "Client %s Unhandled exception in onGet/Put/RPC %s : %s\n",
+                   peerName.c_str(), typeid(e).name(), e.what());
+        if(ctrl)
+            ctrl->error(e.what());
+    }
+}
+
+// A handler call deferred to a Config::handlerWorkers thread
+struct HandlerCall
+{
+    HandlerWorker* handler;
+    std::string peerName;
+    std::unique_ptr<server::ExecOp> ctrl;
+    Value val;
+    onGet_t onGet;
+    onPutRPC_t onPutRPC;
+    epicsUInt64 queued;
+
+    void operator()()
+    {
+        auto start(epicsMonotonicGet());
+        handler->queued.fetch_sub(1u, std::memory_order_relaxed);
+
+        runHandler(peerName, ctrl, val, onGet ? &onGet : nullptr, &onPutRPC);
+
+        auto end(epicsMonotonicGet());
+        Guard G(handler->lock);
+        handler->wait.record(start - queued);
+        handler->service.record(end - start);
+    }
+};
+
 } // namespace
 
 void ServerConn::handle_GPR(pva_app_msg_t cmd)
@@ -459,7 +532,7 @@ void ServerConn::handle_GPR(pva_app_msg_t cmd)
             if(!op->lastRequest)
                 op->lastRequest = subcmd&0x10;
 
-            std::unique_ptr<ServerGPRExec> ctrl{new ServerGPRExec(this, cmd, iface->server->internal_self, chan->name, op)};
+            std::unique_ptr<server::ExecOp> ctrl{new ServerGPRExec(this, cmd, iface->server->internal_self, chan->name, op)};
 
             op->subcmd = subcmd;
             op->state = ServerOp::Executing;
@@ -467,34 +540,50 @@ void ServerConn::handle_GPR(pva_app_msg_t cmd)
             log_debug_printf(connsetup, "Client %s op%x executing %s\n",
                              peerName.c_str(), cmd, chan->name.c_str());
 
-            try {
-                if(cmd==CMD_RPC && isput) {
-                    if(chan->onRPC)
-                        chan->onRPC(std::move(ctrl), std::move(val));
-                    else
-                        ctrl->error("RPC Not Implemented");
-
-                } else if(cmd==CMD_PUT && isput) {
-                    if(op->onPut)
-                        op->onPut(std::move(ctrl), std::move(val));
-                    else
-                        ctrl->error("PUT Not Implemented");
-
-                } else if(cmd!=CMD_RPC && !isput) {
-                    if(op->onGet)
-                        op->onGet(std::move(ctrl));
-                    else
-                        ctrl->error("GET Not Implemented");
-
-                } else {
-                    log_err_printf(connsetup, "Client %s Get exec in incorrect command %d\n",
-                               peerName.c_str(), subcmd);
+            const onGet_t* onGet = nullptr;
+            const onPutRPC_t* onPutRPC = nullptr;
+
+            if(cmd==CMD_RPC && isput) {
+                if(chan->onRPC)
+                    onPutRPC = &chan->onRPC;
+                else
+                    ctrl->error("RPC Not Implemented");
+
+            } else if(cmd==CMD_PUT && isput) {
+                if(op->onPut)
+                    onPutRPC = &op->onPut;
+                else
+                    ctrl->error("PUT Not Implemented");
+
+            } else if(cmd!=CMD_RPC && !isput) {
+                if(op->onGet)
+                    onGet = &op->onGet;
+                else
+                    ctrl->error("GET Not Implemented");
+
+            } else {
+                log_err_printf(connsetup, "Client %s Get exec in incorrect command %d\n",
+                           peerName.c_str(), subcmd);
+            }
+
+            if(!onGet && !onPutRPC) {
+                // already handled
+
+            } else if(auto handler = iface->server->pickHandler(chan->name)) {
+                auto queued(handler->queued.fetch_add(1u, std::memory_order_relaxed) + 1u);
+                {
+                    Guard G(handler->lock);
+                    if(handler->maxQueued < queued)
+                        handler->maxQueued = queued;
                 }
-            } catch(std::exception& e) {
-                log_err_printf(connsetup, "Client %s Unhandled exception in onGet/Put/RPC %s : %s\n",
-                           peerName.c_str(), typeid(e).name(), e.what());
-                if(ctrl)
-                    ctrl->error(e.what());
+
+                HandlerCall call{handler, peerName, std::move(ctrl), std::move(val),
+                            onGet ? *onGet : onGet_t(), onPutRPC ? *onPutRPC : onPutRPC_t(),
+                            epicsMonotonicGet()};
+                handler->loop.dispatch(std::move(call));
+
+            } else {
+                runHandler(peerName, ctrl, val, onGet, onPutRPC);
             }
 
         } else {
@@ -5,6 +5,7 @@
  */
 
 #include <cassert>
+#include <functional>
 
 #include <pvxs/log.h>
 #include "dataimpl.h"
@@ -39,7 +40,7 @@ struct ServerIntrospect final : public ServerOp
             to_wire(R, uint32_t(ioid));
             to_wire(R, sts);
             if(type)
-                to_wire(R, type);
+                to_wire(R, type, conn->txRegistry);
         }
 
         ch->statTx += conn->enqueueTxBody(CMD_GET_FIELD);
@@ -65,6 +66,7 @@ struct ServerIntrospectControl : public server::ConnectOp
                             const std::weak_ptr<ServerIntrospect>& op)
         :server::ConnectOp(chan->name, conn->cred, Info, Value()) // TODO: pvRequest?
         ,server(server)
+        ,loop(conn->worker->loop.internal())
         ,op(op)
     {}
     virtual ~ServerIntrospectControl() {
@@ -73,29 +75,29 @@ struct ServerIntrospectControl : public server::ConnectOp
 
     virtual void connect(const Value& prototype) override final
     {
-        auto desc = Value::Helper::desc(prototype);
-        if(!desc)
+        auto type = Value::Helper::type(prototype);
+        if(!type)
             throw std::logic_error("Can't reply to GET_FIELD with Null prototype");
-        Status sts{Status::Ok};
-        doReply(desc, sts);
+        doReply(std::move(type), Status{Status::Ok});
     }
 
     virtual void error(const std::string &msg) override final
     {
-        Status sts{Status::Error, msg};
-        doReply(nullptr, sts);
+        doReply(nullptr, Status{Status::Error, msg});
     }
 
-    void doReply(const FieldDesc* type, const Status& sts)
+    void doReply(std::shared_ptr<const FieldDesc>&& type, Status&& sts)
     {
         auto serv = server.lock();
         if(!serv)
             return; // soft fail if already completed, canceled, disconnected, ....
 
-        serv->acceptor_loop.call([this, type, &sts](){
+        loop.post(std::bind([](const std::weak_ptr<ServerIntrospect>& op,
+                               const std::shared_ptr<const FieldDesc>& type,
+                               const Status& sts){
             if(auto oper = op.lock())
-                oper->doReply(type, sts);
-        });
+                oper->doReply(type.get(), sts);
+        }, op, std::move(type), std::move(sts)));
     }
 
     virtual void onClose(std::function<void(const std::string&)>&& fn) override final
@@ -103,10 +105,11 @@ struct ServerIntrospectControl : public server::ConnectOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.post(std::bind([](const std::weak_ptr<ServerIntrospect>& op,
+                               std::function<void(const std::string&)>& fn){
             if(auto oper = op.lock())
                 oper->onClose = std::move(fn);
-        });
+        }, op, std::move(fn)));
     }
 
     // we'll never use these, so no reason to store
@@ -114,6 +117,7 @@ struct ServerIntrospectControl : public server::ConnectOp
     virtual void onPut(std::function<void(std::unique_ptr<server::ExecOp>&& fn, Value&&)>&& fn) override final {}
 
     const std::weak_ptr<server::Server::Pvt> server;
+    const evbase loop;
     const std::weak_ptr<ServerIntrospect> op;
 
     INST_COUNTER(ServerIntrospectControl);
@@ -5,6 +5,8 @@
  */
 
 #include <cassert>
+#include <cmath>
+#include <functional>
 
 #include <deque>
 
@@ -20,9 +22,157 @@ namespace pvxs { namespace impl {
 DEFINE_LOGGER(connsetup, "pvxs.tcp.setup");
 DEFINE_LOGGER(connio, "pvxs.tcp.io");
 
+typedef epicsGuard<epicsMutex> Guard;
+
+// Encoded updates of at least this size are referenced into each
+// connection TX buffer instead of being copied.
+static constexpr size_t updateRefThreshold = 4096u;
+
 namespace {
+// approximate memory held by a Value.  dominated by arrays and strings.
+size_t heldBytes(const Value& val)
+{
+    if(!val)
+        return 0u;
+
+    auto top = Value::Helper::store(val)->top;
+    size_t ret = sizeof(FieldStorage)*top->members.size();
+
+    for(auto& fld : top->members) {
+        switch(fld.code) {
+        case StoreType::String:
+            ret += fld.as<std::string>().size();
+            break;
+        case StoreType::Array: {
+            auto& arr = fld.as<shared_array<const void>>();
+            switch(arr.original_type()) {
+            case ArrayType::String: ret += arr.size()*sizeof(std::string); break;
+            case ArrayType::Value:  ret += arr.size()*sizeof(Value); break;
+            default:                ret += arr.size()*elementSize(arr.original_type()); break;
+            }
+        }
+            break;
+        case StoreType::Compound:
+            ret += heldBytes(fld.as<Value>());
+            break;
+        default:
+            break;
+        }
+    }
+    return ret;
+}
 
-typedef epicsGuard<epicsMutex> Guard;
+} // namespace
+
+DEFINE_INST_COUNTER2(UpdateCache::Entry, UpdateCacheEntry);
+
+UpdateCache::Entry::Entry(const Value& val, const BitMask& mask, bool be)
+    :val(val)
+    ,mask(mask.size())
+    ,be(be)
+    ,body(__FILE__, __LINE__, evbuffer_new())
+{
+    this->mask |= mask;
+}
+
+constexpr size_t UpdateCache::nShards;
+
+std::shared_ptr<UpdateCache::Entry> UpdateCache::lookup(const Value& val, const BitMask& mask, bool be,
+                                                        const std::shared_ptr<MemBudget>& budget)
+{
+    // A Value referenced only by the caller can not be posted to other
+    // subscriptions, so skip the cache entirely.
+    if(Value::Helper::use_count(val) <= 1)
+        return nullptr;
+
+    auto key = Value::Helper::store_ptr(val);
+    auto& shard = shards[(size_t(key)/alignof(FieldStorage)) % nShards];
+    auto& entries = shard.entries;
+    auto& purgeAt = shard.purgeAt;
+
+    Guard G(shard.lock);
+
+    std::shared_ptr<MemCharge> charge;
+    auto range = entries.equal_range(key);
+    for(auto it = range.first; it!=range.second; ++it) {
+        auto ent(it->second.lock());
+        if(!ent || Value::Helper::desc(ent->val)!=Value::Helper::desc(val))
+            continue;
+        if(ent->be==be && ent->mask==mask)
+            return ent;
+        // storage is charged once, whatever the mask
+        if(ent->charge)
+            charge = ent->charge;
+    }
+
+    if(entries.size() >= purgeAt) {
+        for(auto it = entries.begin(); it!=entries.end();) {
+            if(it->second.expired())
+                it = entries.erase(it);
+            else
+                ++it;
+        }
+        purgeAt = std::max(size_t(16u), 2u*entries.size());
+    }
+
+    auto ent(std::make_shared<Entry>(val, mask, be));
+    if(charge)
+        ent->charge = std::move(charge);
+    else if(budget)
+        ent->charge = std::make_shared<MemCharge>(budget, heldBytes(val));
+    entries.emplace(key, ent);
+    return ent;
+}
+
+namespace {
+
+void releaseEntry(const void *data, size_t datalen, void *raw)
+{
+    delete static_cast<std::shared_ptr<UpdateCache::Entry>*>(raw);
+}
+
+// on worker.  Append the encoded update to a TX body, encoding on first use.
+// Returns the number of bytes referenced, rather than copied.
+size_t appendUpdate(evbuffer* buf, const std::shared_ptr<UpdateCache::Entry>& ent, size_t refThreshold)
+{
+    Guard G(ent->lock);
+
+    auto body = ent->body.get();
+
+    if(!ent->encoded) {
+        {
+            EvOutBuf M(ent->be, body);
+            M.refThreshold = refThreshold;
+            to_wire_valid(M, ent->val, &ent->mask);
+            // TODO: placeholder for overrun mask
+            to_wire(M, uint8_t(0u));
+            assert(M.good());
+        }
+        ent->encoded = true;
+    }
+
+    // body is not modified once encoded, so its chunks may be referenced.
+    const bool copy = evbuffer_get_length(body) < updateRefThreshold;
+    auto nvec = evbuffer_peek(body, -1, nullptr, nullptr, 0);
+    std::vector<evbuffer_iovec> vecs(nvec);
+    (void)evbuffer_peek(body, -1, nullptr, vecs.data(), nvec);
+
+    for(auto& vec : vecs) {
+        if(copy) {
+            if(evbuffer_add(buf, vec.iov_base, vec.iov_len))
+                throw BAD_ALLOC();
+
+        } else {
+            // each reference keeps the entry alive until sent.
+            auto ref = new std::shared_ptr<UpdateCache::Entry>(ent);
+            if(evbuffer_add_reference(buf, vec.iov_base, vec.iov_len, &releaseEntry, ref)) {
+                delete ref;
+                throw BAD_ALLOC();
+            }
+        }
+    }
+    return copy ? 0u : evbuffer_get_length(body);
+}
 
 struct MonitorOp final : public ServerOp
 {
@@ -39,9 +189,30 @@ struct MonitorOp final : public ServerOp
             }
         };
     }
-    virtual ~MonitorOp() {}
+    virtual ~MonitorOp() {
+        releaseQueue();
+        if(rate) {
+            // may run off the worker when user code drops the last reference.
+            // event_free() on the worker, where rateTimerS() would find 'op' expired.
+            auto loop(rate->loop);
+            loop.tryDispatch(std::bind([](std::shared_ptr<RateLimit>& rate) {
+                                            rate.reset();
+                                        }, std::move(rate)));
+        }
+    }
 
-    // only access from accepter worker thread
+    // caller must hold lock, or have exclusive access
+    void releaseQueue() {
+        if(memory) {
+            for(auto& ent : queue) {
+                memory->sub(ent.nbytes);
+                memory->subShared(ent.nshared);
+            }
+        }
+        queue.clear();
+    }
+
+    // only access from connection worker thread
     std::function<void(bool)> onStart;
     std::function<void()> onLowMark;
     std::function<void()> onHighMark;
@@ -50,7 +221,8 @@ struct MonitorOp final : public ServerOp
 
     // const after setup phase
     std::shared_ptr<const FieldDesc> type;
-    BitMask pvMask;
+    // computed from pvRequest .fields.  shared through Server::Pvt::requestPlans
+    std::shared_ptr<const RequestPlan> plan;
     std::string msg;
 
     // Further members guarded by this lock (except as noted)
@@ -67,33 +239,49 @@ struct MonitorOp final : public ServerOp
     size_t maxQueue=0u;
     size_t nSquash=0u;
 
-    std::deque<Value> queue;
+    struct Update {
+        Value val;
+        // shared encoding of val, or NULL to encode val directly
+        std::shared_ptr<UpdateCache::Entry> enc;
+        // epicsMonotonicGet() when queued
+        epicsUInt64 posted;
+        // counted in memory
+        size_t nbytes;
+        // storage of enc->val, charged to the server total by enc.  counted in memory->shared
+        size_t nshared;
+    };
+    std::deque<Update> queue;
+    // when set, account for bytes held in queue.  cf. Config::memoryBudget
+    std::shared_ptr<MemBudget> memory;
+
+    // record._options.maxRate .  When set, data updates are sent no more often
+    // than once per minInterval (ns.), with later updates squashed into one queued.
+    // const after setup
+    uint64_t minInterval=0u;
+    struct RateLimit {
+        evbase loop;
+        evevent timer;
+        std::weak_ptr<MonitorOp> op;
+    };
+    // timer arg.  Owned separately so that it may outlive the MonitorOp until freed on the worker
+    std::shared_ptr<RateLimit> rate;
+    // epicsMonotonicGet() before which the next data update may not be sent
+    epicsUInt64 nextSend=0u;
 
     INST_COUNTER(MonitorOp);
 
     // caller must hold lock.
     // only used after State==Idle
     static
-    void maybeReply(server::Server::Pvt* server, const std::shared_ptr<MonitorOp>& op)
+    void maybeReply(const evbase& loop, const std::shared_ptr<MonitorOp>& op)
     {
         // can we send a reply?
         if(!op->scheduled && op->state==Executing && !op->queue.empty() && (!op->pipeline || op->window))
         {
             // based on operation state, yes
-            server->acceptor_loop.dispatch([op](){
-                auto ch(op->chan.lock());
-                if(!ch)
-                    return;
-                auto conn(ch->conn.lock());
-                if(!conn || conn->state==ConnBase::Disconnected)
-                    return;
-
-                if(conn->connection() && (bufferevent_get_enabled(conn->connection())&EV_READ)) {
-                    doReply(op);
-                } else {
-                    // connection TX queue is too full
-                    conn->backlog.emplace_back([op]() { doReply(op); });
-                }
+            loop.dispatch([op](){
+                if(!op->waitForRate())
+                    sendReply(op);
             });
 
             op->scheduled = true;
@@ -107,6 +295,53 @@ struct MonitorOp final : public ServerOp
         }
     }
 
+    // on worker
+    static
+    void sendReply(const std::shared_ptr<MonitorOp>& op)
+    {
+        auto ch(op->chan.lock());
+        if(!ch)
+            return;
+        auto conn(ch->conn.lock());
+        if(!conn || conn->state==ConnBase::Disconnected)
+            return;
+
+        if(conn->connection() && (bufferevent_get_enabled(conn->connection())&EV_READ)) {
+            doReply(op);
+        } else {
+            // connection TX queue is too full
+            conn->backlog.emplace_back(epicsMonotonicGet(), [op]() { doReply(op); });
+        }
+    }
+
+    // on worker.  If the next data update may not be sent yet, arm rate->timer and return true.
+    bool waitForRate()
+    {
+        if(!minInterval)
+            return false;
+
+        Guard G(lock);
+        if(state!=Executing || queue.empty() || !queue.front().val)
+            return false;
+
+        auto now(epicsMonotonicGet());
+        if(now >= nextSend)
+            return false;
+
+        timeval tmo(totv((nextSend - now)*1e-9));
+        if(event_add(rate->timer.get(), &tmo))
+            log_err_printf(connio, "Unable to arm maxRate timer%s\n", "");
+        return true;
+    }
+
+    static
+    void rateTimerS(evutil_socket_t fd, short evt, void *raw)
+    {
+        // NULL if MonitorOp already destroyed
+        if(auto op = static_cast<RateLimit*>(raw)->op.lock())
+            sendReply(op);
+    }
+
     static
     void doReply(const std::shared_ptr<MonitorOp>& self)
     {
@@ -136,7 +371,7 @@ struct MonitorOp final : public ServerOp
                                  conn->peerName.c_str(), unsigned(self->ioid));
                 return; // nothing to do
 
-            } else if(!self->queue.front()) {
+            } else if(!self->queue.front().val) {
                 subcmd = 0x10;
                 self->state = Dead;
                 log_debug_printf(connio, "Client %s IOID %u finishes\n",
@@ -144,6 +379,7 @@ struct MonitorOp final : public ServerOp
             }
         }
 
+        std::shared_ptr<UpdateCache::Entry> enc;
         {
             (void)evbuffer_drain(conn->txBody.get(), evbuffer_get_length(conn->txBody.get()));
 
@@ -156,13 +392,18 @@ struct MonitorOp final : public ServerOp
 
                 } else {
                     to_wire(R, Status{});
-                    to_wire(R, self->type.get());
+                    to_wire(R, self->type.get(), conn->txRegistry);
                 }
 
             } else if(!self->queue.empty()) {
                 auto& ent = self->queue.front();
-                if(ent) {
-                    to_wire_valid(R, ent, &self->pvMask);
+                if(ent.enc) {
+                    // appended below, after R is flushed
+                    enc = std::move(ent.enc);
+
+                } else if(ent.val) {
+                    R.refThreshold = conn->iface->server->effective.zeroCopyThreshold;
+                    to_wire_valid(R, ent.val, &self->plan->mask);
                     // TODO: placeholder for overrun mask
                     to_wire(R, uint8_t(0u));
 
@@ -170,10 +411,30 @@ struct MonitorOp final : public ServerOp
                     to_wire(R, Status{});
                 }
 
+                if(self->memory) {
+                    self->memory->sub(ent.nbytes);
+                    self->memory->subShared(ent.nshared);
+                }
+
+                if(ent.val) {
+                    auto now(epicsMonotonicGet());
+                    if(self->minInterval)
+                        self->nextSend = now + self->minInterval;
+
+                    auto delta = now - ent.posted;
+                    conn->statPostEncode.record(delta);
+                    if(!ch->statPostEncode)
+                        ch->statPostEncode.reset(new LatencyHist());
+                    ch->statPostEncode->record(delta);
+                }
+
                 self->queue.pop_front();
             }
         }
 
+        if(enc)
+            conn->txBodyShared += appendUpdate(conn->txBody.get(), enc, conn->iface->server->effective.zeroCopyThreshold);
+
         ch->statTx += conn->enqueueTxBody(pva_app_msg_t::CMD_MONITOR);
 
         if(self->state == ServerOp::Dead) {
@@ -187,7 +448,7 @@ struct MonitorOp final : public ServerOp
 
             if(!self->lowMarkPending && self->window <= self->low && self->onLowMark) {
                 self->lowMarkPending = true;
-                conn->iface->server->acceptor_loop.dispatch([self]() {
+                conn->worker->loop.dispatch([self]() {
                     decltype (self->onLowMark) fn;
                     {
                         Guard G(self->lock);
@@ -205,8 +466,9 @@ struct MonitorOp final : public ServerOp
             // reschedule myself
             assert(!self->scheduled); // we've been holding the lock, so this should not have changed
 
-            conn->iface->server->acceptor_loop.dispatch([self]() {
-                doReply(self);
+            conn->worker->loop.dispatch([self]() {
+                if(!self->waitForRate())
+                    doReply(self);
             });
             self->scheduled = true;
         }
@@ -219,6 +481,11 @@ struct MonitorOp final : public ServerOp
         onHighMark = nullptr;
         onLowMark = nullptr;
         onStart = nullptr;
+        {
+            // no longer sendable
+            Guard G(lock);
+            releaseQueue();
+        }
     }
 
     void show(std::ostream& strm) const override final
@@ -249,8 +516,15 @@ struct ServerMonitorControl : public server::MonitorControlOp
         if(val && mon->type && mon->type.get()!=Value::Helper::desc(val))
             throw std::logic_error("Type change not allowed in post().  Recommend pvxs::Value::cloneEmpty()");
 
-        // pvMask is const at this point, so no need to lock
-        bool real = testmask(val, mon->pvMask);
+        // plan is const at this point, so no need to lock
+        bool real = mon->plan && mon->plan->test(val);
+
+        auto serv(server.lock());
+
+        // when over budget, only queue if nothing is queued
+        bool over = serv && mon->memory && serv->overBudget();
+        if(over)
+            serv->enforceBudget();
 
         Guard G(mon->lock);
         if(mon->finished)
@@ -258,30 +532,63 @@ struct ServerMonitorControl : public server::MonitorControlOp
 
         if(real || !val) {
 
-            if((mon->queue.size() < mon->limit) || force || !val) {
+            // with maxRate, merge into an update waiting to be sent
+            bool coalesce = val && mon->minInterval && !mon->queue.empty() && mon->queue.back().val;
+
+            if(!coalesce && ((mon->queue.size() < mon->limit && !(over && !mon->queue.empty())) || force || !val)) {
 
                 mon->finished = !val;
-                mon->queue.push_back(val);
+                // before Update copies val.  NULL unless val may be shared
+                std::shared_ptr<UpdateCache::Entry> enc;
+                if(val && serv)
+                    enc = serv->updateCache.lookup(val, mon->plan->mask, serv->effective.sendBE(),
+                                                   mon->memory ? serv->memory : nullptr);
+                MonitorOp::Update update{val, std::move(enc), epicsMonotonicGet(), 0u, 0u};
+                if(mon->memory && !update.enc) {
+                    update.nbytes = heldBytes(val);
+                    mon->memory->add(update.nbytes);
+                } else if(mon->memory && update.enc->charge) {
+                    // shared storage is charged once, to the server total, by the cache entry
+                    update.nshared = update.enc->charge->nbytes;
+                    mon->memory->addShared(update.nshared);
+                }
+                mon->queue.push_back(std::move(update));
 
                 if(mon->maxQueue < mon->queue.size())
                     mon->maxQueue = mon->queue.size();
 
-            } else if(!maybe) {
+            } else if(!maybe || coalesce) {
                 // squash
                 assert(mon->limit>0 && !mon->queue.empty());
 
-                mon->queue.back().assign(val);
+                // queued Value may be shared with other subscriptions, or cached encoding,
+                // so merge into a copy unless this queue holds the only reference.
+                auto& back = mon->queue.back();
+                back.enc.reset();
+                if(mon->memory) {
+                    mon->memory->subShared(back.nshared);
+                    back.nshared = 0u;
+                }
+                if(Value::Helper::store(back.val).use_count()!=1)
+                    back.val = back.val.clone();
+                back.val.assign(val);
                 mon->nSquash++;
+                if(mon->memory) {
+                    auto nbytes = heldBytes(back.val);
+                    mon->memory->add(nbytes);
+                    mon->memory->sub(back.nbytes);
+                    back.nbytes = nbytes;
+                }
 
             } else {
                 // nope
             }
 
-            if(auto serv = server.lock())
-                MonitorOp::maybeReply(serv.get(), mon);
+            if(serv)
+                MonitorOp::maybeReply(loop, mon);
         }
 
-        return mon->queue.size() < mon->limit;
+        return mon->queue.size() < mon->limit && !over;
     }
 
     virtual void stats(server::MonitorStat& stat, bool reset) const override final
@@ -300,7 +607,7 @@ struct ServerMonitorControl : public server::MonitorControlOp
         stat.maxQueue = mon->maxQueue;
         stat.limitQueue = mon->limit;
         stat.window = mon->window;
-        stat.nQueue = mon->nSquash;
+        stat.nSquash = mon->nSquash;
 
         if(reset)
             mon->maxQueue = mon->nSquash = 0u;
@@ -314,7 +621,8 @@ struct ServerMonitorControl : public server::MonitorControlOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, low, high](){
+        auto op(this->op);
+        loop.post([op, low, high](){
             if(auto oper = op.lock()) {
                 Guard G(oper->lock);
                 oper->low = std::min(low, oper->ackAt-1u);
@@ -329,33 +637,37 @@ struct ServerMonitorControl : public server::MonitorControlOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.post(std::bind([](const std::weak_ptr<MonitorOp>& op,
+                               std::function<void(bool)>& fn){
             if(auto oper = op.lock())
                 oper->onStart = std::move(fn);
-        });
+        }, op, std::move(fn)));
     }
     virtual void onHighMark(std::function<void ()> &&fn) override final
     {
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.post(std::bind([](const std::weak_ptr<MonitorOp>& op,
+                               std::function<void()>& fn){
             if(auto oper = op.lock())
                 oper->onHighMark = std::move(fn);
-        });
+        }, op, std::move(fn)));
     }
     virtual void onLowMark(std::function<void ()> &&fn) override final
     {
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.post(std::bind([](const std::weak_ptr<MonitorOp>& op,
+                               std::function<void()>& fn){
             if(auto oper = op.lock())
                 oper->onLowMark = std::move(fn);
-        });
+        }, op, std::move(fn)));
     }
 
     const std::weak_ptr<server::Server::Pvt> server;
+    const evbase loop;
     const std::weak_ptr<MonitorOp> op;
 
     INST_COUNTER(ServerMonitorControl);
@@ -371,6 +683,7 @@ struct ServerMonitorSetup : public server::MonitorSetupOp
                      const std::weak_ptr<MonitorOp>& op)
         :MonitorSetupOp(name, conn->cred, Info, request)
         ,server(server)
+        ,loop(conn->worker->loop.internal())
         ,op(op)
     {}
     virtual ~ServerMonitorSetup() {
@@ -382,26 +695,38 @@ struct ServerMonitorSetup : public server::MonitorSetupOp
         if(!prototype)
             throw std::invalid_argument("Must provide prototype");
         auto type = Value::Helper::type(prototype);
-        auto mask = request2mask(type.get(), _pvRequest);
+        auto serv = server.lock();
+        // validate pvRequest even if the server has stopped
+        auto plan(serv ? serv->requestPlans.lookup(type, _pvRequest)
+                       : std::make_shared<const RequestPlan>(type.get(), _pvRequest));
+
+        if(connected)
+            throw std::logic_error("Operation already connected");
+        connected = true;
 
         std::unique_ptr<server::MonitorControlOp> ret;
 
-        auto serv = server.lock();
         if(!serv)
             return ret;
-        serv->acceptor_loop.call([this, &type, &ret, &mask](){
-            if(auto oper = op.lock()) {
-                if(oper->state!=ServerOp::Creating)
-                    return;
-                oper->type = type;
-                oper->pvMask = std::move(mask);
-                ret.reset(new ServerMonitorControl(this, server, _name, oper));
-                MonitorOp::doReply(oper);
-            }
-        });
-        if(!ret)
+        auto oper(op.lock());
+        if(!oper)
             throw std::runtime_error("Dead Operation");
 
+        {
+            // set now as post() through the returned MonitorControlOp may be called before the reply below is sent.
+            // Not otherwise accessed until state==Executing.
+            Guard G(oper->lock);
+            oper->type = type;
+            oper->plan = std::move(plan);
+        }
+        ret.reset(new ServerMonitorControl(this, server, _name, oper));
+
+        loop.post([oper](){
+            if(oper->state!=ServerOp::Creating)
+                return;
+            MonitorOp::doReply(oper);
+        });
+
         return ret;
     }
     virtual void error(const std::string &msg) override final
@@ -412,7 +737,7 @@ struct ServerMonitorSetup : public server::MonitorSetupOp
         if(!serv)
             return;
         auto op(this->op);
-        serv->acceptor_loop.dispatch([op, msg]() mutable {
+        loop.dispatch([op, msg]() mutable {
             if(auto oper = op.lock()) {
                 if(oper->state==ServerOp::Creating) {
                     oper->msg = std::move(msg);
@@ -426,14 +751,18 @@ struct ServerMonitorSetup : public server::MonitorSetupOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.post(std::bind([](const std::weak_ptr<MonitorOp>& op,
+                               std::function<void(const std::string&)>& fn){
             if(auto oper = op.lock())
                 oper->onClose = std::move(fn);
-        });
+        }, op, std::move(fn)));
     }
 
     const std::weak_ptr<server::Server::Pvt> server;
+    const evbase loop;
     const std::weak_ptr<MonitorOp> op;
+    // connect() called.  only accessed by the owner of this MonitorSetupOp
+    bool connected = false;
 
     INST_COUNTER(ServerMonitorSetup);
 };
@@ -446,6 +775,7 @@ ServerMonitorControl::ServerMonitorControl(ServerMonitorSetup* setup,
                                            const std::weak_ptr<MonitorOp>& op)
     :server::MonitorControlOp(name, setup->credentials(), Info)
     ,server(server)
+    ,loop(setup->loop)
     ,op(op)
 {}
 
@@ -491,6 +821,7 @@ void ServerConn::handle_MONITOR()
         chan->statRx += rxlen;
 
         auto op(std::make_shared<MonitorOp>(chan, ioid));
+        op->memory = memory;
         op->window = nack;
         (void)pvRequest["record._options.pipeline"].as(op->pipeline);
 
@@ -501,6 +832,23 @@ void ServerConn::handle_MONITOR()
         if(op->limit < op->window)
             op->limit = op->window;
 
+        pvRequest["record._options.maxRate"].as<double>([this, &op](double rate){
+            if(!std::isfinite(rate) || rate<=0.0) {
+                log_warn_printf(connio, "Ignoring invalid maxRate %g\n", rate);
+                return;
+            }
+            // at least once per hour.  Also avoids overflowing uint64_t for tiny rates.
+            op->minInterval = uint64_t(std::min(1e9/rate, 3600e9));
+            if(!op->minInterval)
+                op->minInterval = 1u;
+            auto rl(std::make_shared<MonitorOp::RateLimit>());
+            rl->loop = worker->loop;
+            rl->op = op;
+            rl->timer = evevent(__FILE__, __LINE__,
+                                event_new(worker->loop.base, -1, EV_TIMEOUT, &MonitorOp::rateTimerS, rl.get()));
+            op->rate = std::move(rl);
+        });
+
         if(!op->limit)
             op->limit = 1u;
 
@@ -609,7 +957,7 @@ void ServerConn::handle_MONITOR()
 
             if(!op->highMarkPending && op->window > op->high && op->onHighMark && !op->finished) {
                 op->highMarkPending = true;
-                iface->server->acceptor_loop.dispatch([op](){
+                worker->loop.dispatch([op](){
                     decltype(op->onHighMark) fn;
                     {
                         Guard G(op->lock);
@@ -639,7 +987,7 @@ void ServerConn::handle_MONITOR()
 
             {
                 Guard G(op->lock);
-                MonitorOp::maybeReply(iface->server, op);
+                MonitorOp::maybeReply(worker->loop, op);
             }
         }
 
@@ -652,7 +1000,7 @@ void ServerConn::handle_MONITOR()
                 auto self(it->second);
                 opByIOID.erase(it);
 
-                iface->server->acceptor_loop.dispatch([self](){
+                worker->loop.dispatch([self](){
                     self->cleanup();
                 });
 
@@ -13,6 +13,49 @@ namespace impl {
 
 DEFINE_LOGGER(srvsrc, "pvxs.server.src");
 
+namespace {
+
+void fillLatency(Value&& fld, const Report& rpt, Report::Latency Report::Connection::* lat)
+{
+    auto N = rpt.connections.size();
+    shared_array<uint64_t> count(N);
+    shared_array<double> p50(N), p99(N), p999(N), max(N);
+
+    size_t i=0u;
+    for(auto& conn : rpt.connections) {
+        auto& L = conn.*lat;
+        count[i] = L.count;
+        p50[i] = L.p50;
+        p99[i] = L.p99;
+        p999[i] = L.p999;
+        max[i] = L.max;
+        i++;
+    }
+
+    fld["count"] = count.freeze();
+    fld["p50"] = p50.freeze();
+    fld["p99"] = p99.freeze();
+    fld["p999"] = p999.freeze();
+    fld["max"] = max.freeze();
+}
+
+Value latencyReport(const Report& rpt, const Value& proto)
+{
+    shared_array<std::string> peer(rpt.connections.size());
+    size_t i=0u;
+    for(auto& conn : rpt.connections)
+        peer[i++] = conn.peer;
+
+    auto ret(proto.cloneEmpty());
+    ret["peer"] = peer.freeze();
+    fillLatency(ret["postToEncode"], rpt, &Report::Connection::postToEncode);
+    fillLatency(ret["encodeToWrite"], rpt, &Report::Connection::encodeToWrite);
+    fillLatency(ret["backlogWait"], rpt, &Report::Connection::backlogWait);
+    return ret;
+}
+
+} // namespace
+
 ServerSource::ServerSource(server::Server::Pvt* serv)
     :name("server")
     ,serv(serv)
@@ -20,6 +63,23 @@ ServerSource::ServerSource(server::Server::Pvt* serv)
                       Member(TypeCode::String, "implLang"),
                       Member(TypeCode::String, "version"),
                   }).create())
+    ,latency([]() {
+        auto hist = [](const char* name) {
+            return Member(TypeCode::Struct, name, {
+                              Member(TypeCode::UInt64A, "count"),
+                              Member(TypeCode::Float64A, "p50"),
+                              Member(TypeCode::Float64A, "p99"),
+                              Member(TypeCode::Float64A, "p999"),
+                              Member(TypeCode::Float64A, "max"),
+                          });
+        };
+        return TypeDef(TypeCode::Struct, {
+                           Member(TypeCode::StringA, "peer"),
+                           hist("postToEncode"),
+                           hist("encodeToWrite"),
+                           hist("backlogWait"),
+                       }).create();
+    }())
 {}
 
 void ServerSource::onSearch(Search &op)
@@ -27,6 +87,11 @@ void ServerSource::onSearch(Search &op)
     // nothing.  our "server" PV is not advertised
 }
 
+std::shared_ptr<const SearchIndexed::names_t> ServerSource::searchNames()
+{
+    return nullptr; // see onSearch()
+}
+
 void ServerSource::onCreate(std::unique_ptr<server::ChannelControl> &&op)
 {
     if(op->name()!=name)
@@ -80,6 +145,11 @@ void ServerSource::onCreate(std::unique_ptr<server::ChannelControl> &&op)
             eop->reply(ret);
             return;
 
+        } else if(op=="latency") {
+            // Pvt::report() collects from this TCP worker while waiting on the others.
+            eop->reply(latencyReport(serv->report(false), latency));
+            return;
+
         } else if(op=="info") {
             auto ret = info.cloneEmpty();
 
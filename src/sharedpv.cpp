@@ -18,6 +18,7 @@
 
 #include "utilpvt.h"
 #include "dataimpl.h"
+#include "serverconn.h"
 
 typedef epicsGuard<epicsMutex> Guard;
 typedef epicsGuardRelease<epicsMutex> UnGuard;
@@ -110,13 +111,15 @@ SharedPV SharedPV::buildMailbox()
 
     ret.onPut([](SharedPV& pv, std::unique_ptr<ExecOp>&& op, Value&& val) {
 
-        auto ts(val["timeStamp"]);
-        if(ts && !ts.isMarked(true, true)) {
-            // use current time
-            epicsTimeStamp now;
-            if(!epicsTimeGetCurrent(&now)) {
-                ts["secondsPastEpoch"] = now.secPastEpoch + POSIX_TIME_AT_EPICS_EPOCH;
-                ts["nanoseconds"] = now.nsec;
+        {
+            auto ts(val["timeStamp"]);
+            if(ts && !ts.isMarked(true, true)) {
+                // use current time
+                epicsTimeStamp now;
+                if(!epicsTimeGetCurrent(&now)) {
+                    ts["secondsPastEpoch"] = now.secPastEpoch + POSIX_TIME_AT_EPICS_EPOCH;
+                    ts["nanoseconds"] = now.nsec;
+                }
             }
         }
 
@@ -124,7 +127,8 @@ SharedPV SharedPV::buildMailbox()
                          op->peerName().c_str(), op->name().c_str(),
                          std::string(SB()<<val).c_str());
 
-        pv.post(val);
+        // no other references remain, so subscribers can share val without a copy
+        pv.post(std::move(val));
 
         op->reply();
     });
@@ -233,6 +237,7 @@ void SharedPV::attach(std::unique_ptr<ChannelControl>&& ctrlop)
 
             log_debug_printf(logshared, "%s on %s OP onClose\n", conn->peerName().c_str(), conn->name().c_str());
 
+            Guard G(self->lock);
             self->pending.erase(conn);
         });
 
@@ -414,7 +419,10 @@ void SharedPV::close()
     }
 }
 
-void SharedPV::post(const Value& val)
+namespace {
+// Subscriber queues, and the encoded update cache, share one Value which must not change.
+// Only the caller's own Value, with no other references, can be shared without a copy.
+void doPost(const std::shared_ptr<SharedPV::Impl>& impl, Value& val, bool owned)
 {
     if(!impl)
         throw std::logic_error("Empty SharedPV");
@@ -433,12 +441,35 @@ void SharedPV::post(const Value& val)
     if(impl->subscribers.empty())
         return;
 
-    auto copy(val.clone());
+    Value snapshot;
+    if(owned && Value::Helper::store(val).use_count()==1)
+        snapshot = std::move(val);
+    else
+        snapshot = val.clone();
+
+    // with more than one subscriber, hold a second reference so that the first
+    // also finds snapshot shared, and queues the shared encoding.  cf. UpdateCache::lookup()
+    Value fanout;
+    if(impl->subscribers.size() > 1u)
+        fanout = snapshot;
 
     for(auto& sub : impl->subscribers) {
-        sub->post(copy);
+        sub->post(snapshot);
     }
 }
+} // namespace
+
+void SharedPV::post(const Value& val)
+{
+    auto temp(val);
+    doPost(impl, temp, false);
+}
+
+void SharedPV::post(Value&& val)
+{
+    auto temp(std::move(val));
+    doPost(impl, temp, true);
+}
 
 void SharedPV::fetch(Value& val) const
 {
@@ -468,13 +499,46 @@ Value SharedPV::fetch() const
     }
 }
 
-struct StaticSource::Impl final : public Source
+struct StaticSource::Impl final : public Source, public impl::SearchIndexed
 {
     mutable RWLock lock;
 
     list_t pvs;
     decltype (List::names) list;
 
+    // snapshot of pvs keys for Server search.  cleared by add()/remove() while
+    // holding lock for write.  rebuilt on demand while holding lock for read.
+    epicsMutex indexLock;
+    std::shared_ptr<const names_t> index;
+
+    void resetIndex()
+    {
+        Guard G(indexLock);
+        index.reset();
+    }
+
+    virtual std::shared_ptr<const names_t> searchNames() override
+    {
+        {
+            Guard G(indexLock);
+            if(index)
+                return index;
+        }
+
+        auto G(lock.lockReader());
+
+        auto temp(std::make_shared<names_t>());
+        temp->reserve(pvs.size());
+        for(auto& pair : pvs) {
+            temp->emplace(pair.first);
+        }
+
+        std::shared_ptr<const names_t> ret(std::move(temp));
+        Guard I(indexLock);
+        index = ret;
+        return ret;
+    }
+
     virtual void onSearch(Search &op) override
     {
         auto G(lock.lockReader());
@@ -577,6 +641,7 @@ StaticSource& StaticSource::add(const std::string& name, const SharedPV &pv)
 
     impl->pvs[name] = pv;
     impl->list.reset();
+    impl->resetIndex();
 
     return *this;
 }
@@ -596,6 +661,7 @@ StaticSource& StaticSource::remove(const std::string& name)
         pv = it->second;
         impl->pvs.erase(it);
         impl->list.reset();
+        impl->resetIndex();
     }
 
     pv.close();
@@ -279,6 +279,8 @@ void Member::Helper::build_tree(std::vector<FieldDesc>& desc, const Member& node
         }
     }
 
+    desc[index].buildIndex();
+
     assert(desc.size()==index+desc[index].size());
 }
 
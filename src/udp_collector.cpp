@@ -33,6 +33,16 @@ DEFINE_LOGGER(logsetup, "pvxs.udp.setup");
 
 DEFINE_INST_COUNTER(UDPListener);
 
+// size of a CMD_ORIGIN_TAG prefix header
+static constexpr size_t cmd_origin_tag_size = 8 + 16;
+// size of a receive buffer slot.  space for a CMD_ORIGIN_TAG prefix, the largest UDP payload,
+// and one extra byte for a nil after the last PV name of a Search.
+static constexpr size_t rx_slot_size = cmd_origin_tag_size + 0x10000 + 1;
+// number of datagrams received with one recvfromx::callMany()
+static constexpr size_t rx_batch = 16u;
+// max. datagrams to handle before going back to the reactor
+static constexpr size_t rx_budget = 4u*rx_batch;
+
 struct UDPCollector final : public UDPManager::Search,
                             public std::enable_shared_from_this<UDPCollector>
 {
@@ -46,7 +56,11 @@ struct UDPCollector final : public UDPManager::Search,
     evevent rx;
     uint32_t prevndrop{};
 
-    std::vector<uint8_t> buf;
+    // rx_batch slots of rx_slot_size.  Not initialized, so pages are only touched
+    // when some datagram is received into them.
+    std::unique_ptr<uint8_t[]> buf;
+    std::vector<SockAddr> rxsrc, rxdest;
+    std::vector<recvfromx> rxops;
 
     UDPManager::Beacon beaconMsg;
 
@@ -58,7 +72,8 @@ struct UDPCollector final : public UDPManager::Search,
     void addListener(UDPListener *l);
     void delListener(UDPListener *l);
 
-    bool handle_one();
+    size_t handle_batch();
+    void handle_one(const recvfromx& rx);
 
     enum origin_t {
         Remote,    // non-local sender
@@ -76,8 +91,13 @@ struct UDPCollector final : public UDPManager::Search,
             if(!(ev&EV_READ))
                 return;
 
-            // handle up to 4 packets before going back to the reactor
-            for(unsigned i=0; i<4 && self->handle_one(); i++) {}
+            // handle up to rx_budget packets before going back to the reactor
+            for(size_t n=0u; n<rx_budget; ) {
+                auto nrx = self->handle_batch();
+                if(!nrx)
+                    break;
+                n += nrx;
+            }
 
         }catch(std::exception& e) {
             log_crit_printf(logio, "Ignoring unhandled exception in UDPManager::handle(): %s\n", e.what());
@@ -142,10 +162,23 @@ UDPCollector::UDPCollector(UDPManager::Pvt *manager, int af, uint16_t requested_
     ,sock(af, SOCK_DGRAM, 0)
     ,rx(__FILE__, __LINE__,
         event_new(manager->loop.base, sock.sock, EV_READ|EV_PERSIST, &handle_static, this))
+    ,buf(new uint8_t[rx_batch*rx_slot_size])
+    ,rxsrc(rx_batch)
+    ,rxdest(rx_batch)
+    ,rxops(rx_batch)
     ,beaconMsg(src)
 {
     manager->loop.assertInLoop();
 
+    for(auto i : range(rx_batch)) {
+        auto& op = rxops[i];
+        op.sock = sock.sock;
+        op.buf = &buf[i*rx_slot_size + cmd_origin_tag_size];
+        op.buflen = rx_slot_size - cmd_origin_tag_size - 1u;
+        op.src = &rxsrc[i];
+        op.dst = &rxdest[i];
+    }
+
     epicsSocketEnableAddressUseForDatagramFanout(sock.sock);
     sock.enable_SO_RXQ_OVFL();
     sock.enable_IP_PKTINFO();
@@ -221,26 +254,10 @@ void UDPCollector::delListener(UDPListener *l)
     // TODO: bother to cleanup mcast group membership?
 }
 
-// size of a CMD_ORIGIN_TAG prefix header
-static constexpr size_t cmd_origin_tag_size = 8 + 16;
 
-bool UDPCollector::handle_one()
+size_t UDPCollector::handle_batch()
 {
-    SockAddr dest;
-
-    buf.resize(cmd_origin_tag_size + 0x10000 + 1);
-    auto rxbuf = &buf[cmd_origin_tag_size];
-    auto rxlen = buf.size()-cmd_origin_tag_size-1;
-
-    // For Search messages, we use PV name strings in-place by adding nils.
-    // Ensure one extra byte at the end of the buffer for a nil after the last PV name
-    recvfromx rx{sock.sock, (char*)rxbuf, rxlen, &src, &dest};
-    const int nrx = rx.call();
-
-    if(nrx>=0 && rx.ndrop!=0u && prevndrop!=rx.ndrop) {
-        log_debug_printf(logio, "UDP collector socket buffer overflowed %u -> %u\n", unsigned(prevndrop), unsigned(rx.ndrop));
-        prevndrop = rx.ndrop;
-    }
+    const int nrx = recvfromx::callMany(rxops.data(), rxops.size());
 
     if(nrx<0) {
         int err = evutil_socket_geterror(sock.sock);
@@ -248,17 +265,34 @@ bool UDPCollector::handle_one()
             log_warn_printf(logio, "UDP RX Error on %s : %s\n", name.c_str(),
                             evutil_socket_error_to_string(err));
         }
-        return false; // wait for more I/O
+        return 0u; // wait for more I/O
+    }
+
+    for(auto i : range(size_t(nrx))) {
+        handle_one(rxops[i]);
+    }
+    return size_t(nrx);
+}
 
+void UDPCollector::handle_one(const recvfromx& rx)
+{
+    if(rx.ndrop!=0u && prevndrop!=rx.ndrop) {
+        log_debug_printf(logio, "UDP collector socket buffer overflowed %u -> %u\n", unsigned(prevndrop), unsigned(rx.ndrop));
+        prevndrop = rx.ndrop;
     }
 
+    auto rxbuf = static_cast<const uint8_t*>(rx.buf);
+    const auto nrx = rx.nrx;
+    src = *rx.src;
+    SockAddr dest(*rx.dst);
+
     if(dest.family()!=AF_UNSPEC)
         dest.setPort(bind_addr.port());
 
     if(src.isMCast()) {
         // should never happen.  It it does, we won't be tricked into amplifying a DDoS.
         log_debug_printf(logio, "Ignoring UDP with mcast source %s.\n", src.tostring().c_str());
-        return true;
+        return;
     }
 
     log_hex_printf(logio, Level::Debug, rxbuf, nrx, "UDP Rx %d, %s -> %s @%u (%s)\n",
@@ -267,7 +301,6 @@ bool UDPCollector::handle_one()
     origin_t origin = manager->ifmap.is_iface(src) ? Local : Remote;
 
     process_one(dest, rxbuf, nrx, origin);
-    return true;
 }
 
 void UDPCollector::process_one(const SockAddr &dest, const uint8_t *buf, size_t nrx, origin_t origin)
@@ -323,7 +356,7 @@ void UDPCollector::process_one(const SockAddr &dest, const uint8_t *buf, size_t
             // invalid, bcast, or not ipv4
 
         } else if(dest.compare(lo_mcast_addr.addr,false)!=0) {
-            assert(buf==&this->buf[cmd_origin_tag_size]);
+            assert(size_t(buf - this->buf.get()) % rx_slot_size == cmd_origin_tag_size);
             // clear unicast flag in forwarded message
             *save_flags &= ~pva_search_flags::Unicast;
             // recipient of forwarded message must use, and trust, replyAddr in body :(
@@ -464,21 +497,22 @@ void UDPCollector::forwardM(const SockAddr& origin, const uint8_t *pbuf, size_t
     log_debug_printf(logio, "Forward as originated for %s\n",
                      origin.tostring().c_str());
 
-    assert(buf.size() > cmd_origin_tag_size);
-    assert(pbuf==&buf[cmd_origin_tag_size]);
+    // prefix is written into the space reserved before each receive slot
+    assert(size_t(pbuf - buf.get()) % rx_slot_size == cmd_origin_tag_size);
+    auto prefix = const_cast<uint8_t*>(pbuf) - cmd_origin_tag_size;
 
     {
-        FixedBuf M(true, &buf[0], cmd_origin_tag_size);
+        FixedBuf M(true, prefix, cmd_origin_tag_size);
 
         to_wire(M, Header{CMD_ORIGIN_TAG, 0, 16u});
         to_wire(M, origin);
         assert(M.good());
-        assert(M.save()==&buf[cmd_origin_tag_size]);
+        assert(M.save()==pbuf);
     }
 
     sock.mcast_prep_sendto(lo_mcast_addr);
     src = lo_mcast_addr.addr;
-    reply(&buf[0], cmd_origin_tag_size+plen);
+    reply(prefix, cmd_origin_tag_size+plen);
 }
 
 bool UDPCollector::reply(const void *msg, size_t msglen) const
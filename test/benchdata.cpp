@@ -144,6 +144,42 @@ void benchArraySerDes(bool be, const shared_array<const E>& arr)
     testShow()<<" Des "<<Tdes;
 }
 
+// throughput of swapCopy() vs. the naive per-byte loop it replaces
+template<size_t esize>
+void benchSwap(size_t nbytes)
+{
+    testDiag("%s<%zu>(%zu) using %s", __func__, esize, nbytes, swapCopyImpl());
+
+    constexpr size_t niter = 100u;
+
+    std::vector<uint8_t> src(nbytes), dest(nbytes);
+    for(auto i : range(nbytes))
+        src[i] = uint8_t(i);
+
+    Sampler Tnaive, Tswap;
+
+    for(auto n : range(niter)) {
+        (void)n;
+        StopWatch W;
+
+        (void)W.click();
+        for(size_t i=0; i<nbytes; i+=esize) {
+            for(size_t n=0u; n<esize; n++) {
+                dest[i + esize-1-n] = src[i + n];
+            }
+        }
+        Tnaive.sample(W.click());
+
+        (void)W.click();
+        swapCopy(dest.data(), src.data(), nbytes, esize);
+        Tswap.sample(W.click());
+    }
+
+    // epicsMonotonicGet() in ns, so bytes/ns == GB/s
+    testShow()<<" Naive "<<Tnaive<<" "<<nbytes/Tnaive.mean()<<" GB/s";
+    testShow()<<" Swap  "<<Tswap<<" "<<nbytes/Tswap.mean()<<" GB/s";
+}
+
 } // namespace
 
 MAIN(benchdata)
@@ -172,5 +208,12 @@ MAIN(benchdata)
         benchArraySerDes<std::string>(hostBE, arr);
         benchArraySerDes<std::string>(!hostBE, arr);
     }
+    testDiag("byte order swap kernels");
+    {
+        constexpr size_t nbytes = 4u<<20u;
+        benchSwap<2u>(nbytes);
+        benchSwap<4u>(nbytes);
+        benchSwap<8u>(nbytes);
+    }
     return testDone();
 }
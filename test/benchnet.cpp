@@ -0,0 +1,333 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+
+/* End-to-end benchmark of an in-process server and client(s) over loopback.
+ *
+ * For GET, PUT, RPC and MONITOR with scalar, small array, and large array payloads,
+ * and with increasing numbers of client connections, reports:
+ *
+ * - operations (or delivered updates) per second
+ * - payload bytes per second (size of the "value" field, not wire bytes)
+ * - latency percentiles p50, p99, p999
+ * - process CPU time per operation (server and client together)
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <ctime>
+#include <ostream>
+#include <algorithm>
+
+#include <epicsTime.h>
+#include <epicsEvent.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsUnitTest.h>
+#include <testMain.h>
+
+#include <pvxs/client.h>
+#include <pvxs/server.h>
+#include <pvxs/sharedpv.h>
+#include <pvxs/nt.h>
+#include <pvxs/log.h>
+#include <pvxs/unittest.h>
+
+#include <utilpvt.h>
+
+namespace {
+using namespace pvxs;
+
+typedef epicsGuard<epicsMutex> Guard;
+
+struct Payload {
+    const char *name;
+    size_t nelem; // zero for scalar
+    size_t niter;
+
+    size_t nbytes() const { return nelem ? nelem*sizeof(double) : sizeof(double); }
+};
+
+const Payload payloads[] = {
+    {"scalar", 0u, 2000u},
+    {"small array", 1024u, 2000u},
+    {"4MB array", 512u*1024u, 20u},
+};
+
+const size_t nconns[] = {1u, 4u, 16u};
+
+struct Result {
+    epicsMutex lock;
+    std::vector<double> latency; // seconds
+    size_t nops = 0u;
+    size_t nfail = 0u;
+
+    void add(const std::vector<double>& lat) {
+        Guard G(lock);
+        latency.insert(latency.end(), lat.begin(), lat.end());
+        nops += lat.size();
+    }
+};
+
+struct StopWatch {
+    epicsUInt64 start = 0u;
+
+    // seconds since last click()
+    double click() {
+        epicsUInt64 now(epicsMonotonicGet());
+        double ret = (now-start)*1e-9;
+        start = now;
+        return ret;
+    }
+};
+
+double percentile(const std::vector<double>& sorted, double p)
+{
+    if(sorted.empty())
+        return 0.0;
+    auto idx = size_t(p*(sorted.size()-1u) + 0.5);
+    return sorted[std::min(idx, sorted.size()-1u)];
+}
+
+void report(const char *op, const Payload& pay, size_t nconn, Result& res,
+            double elapsed, double cpu)
+{
+    std::sort(res.latency.begin(), res.latency.end());
+
+    auto rate = res.nops/elapsed;
+    testShow()<<op<<" "<<pay.name<<" conn="<<nconn
+              <<" N="<<res.nops
+              <<" "<<rate<<" op/s "
+              <<rate*pay.nbytes()/1048576.0<<" MB/s"
+              <<" p50="<<percentile(res.latency, 0.50)*1e6
+              <<" p99="<<percentile(res.latency, 0.99)*1e6
+              <<" p999="<<percentile(res.latency, 0.999)*1e6<<" us"
+              <<" cpu/op="<<(res.nops ? cpu/res.nops*1e6 : 0.0)<<" us";
+    if(res.nfail)
+        testDiag("%s %s conn=%zu %zu failures", op, pay.name, nconn, res.nfail);
+}
+
+struct Bench {
+    const Payload& pay;
+    Value prototype;
+    shared_array<const double> arr;
+    server::SharedPV pv;
+    server::Server serv;
+    std::vector<client::Context> clis;
+
+    explicit Bench(const Payload& pay)
+        :pay(pay)
+        ,prototype(nt::NTScalar{pay.nelem ? TypeCode::Float64A : TypeCode::Float64}.create())
+        ,pv(server::SharedPV::buildMailbox())
+        ,serv(server::Config::isolated()
+              .build()
+              .addPV("bench", pv))
+    {
+        if(pay.nelem) {
+            shared_array<double> temp(pay.nelem);
+            for(auto i : range(temp.size()))
+                temp[i] = double(i);
+            arr = temp.freeze();
+        }
+
+        pv.onRPC([](server::SharedPV&, std::unique_ptr<server::ExecOp>&& op, Value&& arg) {
+            op->reply(arg); // echo
+        });
+
+        pv.open(fill(0u));
+        serv.start();
+    }
+
+    ~Bench() {
+        for(auto& cli : clis)
+            cli.close();
+        serv.stop();
+        pv.close();
+    }
+
+    Value fill(uint64_t tag) const {
+        auto val(prototype.cloneEmpty());
+        if(pay.nelem)
+            val["value"] = arr;
+        else
+            val["value"] = 1.0;
+        // stash a monotonic time for MONITOR latency.  zero for the initial value.
+        val["timeStamp.secondsPastEpoch"] = tag;
+        return val;
+    }
+
+    void connect(size_t nconn) {
+        while(clis.size() < nconn) {
+            clis.push_back(serv.clientConfig().build());
+            // complete connection setup before timing
+            clis.back().get("bench").exec()->wait(5.0);
+        }
+    }
+
+    // run fn concurrently on each of the first nconn clients, pay.niter times each
+    template<typename Fn>
+    void runOps(const char *name, size_t nconn, Fn&& fn)
+    {
+        connect(nconn);
+
+        Result res;
+        std::vector<std::thread> workers;
+        workers.reserve(nconn);
+
+        StopWatch W;
+        auto cpu0 = std::clock();
+        (void)W.click();
+
+        for(auto c : range(nconn)) {
+            workers.emplace_back([this, c, &res, &fn]() {
+                std::vector<double> lat;
+                lat.reserve(pay.niter);
+                StopWatch T;
+                try {
+                    for(auto n : range(pay.niter)) {
+                        (void)n;
+                        (void)T.click();
+                        fn(clis[c]);
+                        lat.push_back(T.click());
+                    }
+                }catch(std::exception& e){
+                    testDiag("Error %s : %s", typeid(e).name(), e.what());
+                    Guard G(res.lock);
+                    res.nfail++;
+                }
+                res.add(lat);
+            });
+        }
+        for(auto& w : workers)
+            w.join();
+
+        auto elapsed = W.click();
+        auto cpu = double(std::clock() - cpu0)/CLOCKS_PER_SEC;
+
+        report(name, pay, nconn, res, elapsed, cpu);
+    }
+
+    void benchGet(size_t nconn) {
+        runOps("GET", nconn, [](client::Context& cli) {
+            cli.get("bench").exec()->wait(5.0);
+        });
+    }
+
+    void benchPut(size_t nconn) {
+        runOps("PUT", nconn, [this](client::Context& cli) {
+            auto op = cli.put("bench");
+            if(pay.nelem)
+                op.set("value", arr);
+            else
+                op.set("value", 1.0);
+            op.exec()->wait(5.0);
+        });
+    }
+
+    void benchRPC(size_t nconn) {
+        auto arg(fill(0u));
+        runOps("RPC", nconn, [&arg](client::Context& cli) {
+            cli.rpc("bench", arg.clone()).exec()->wait(5.0);
+        });
+    }
+
+    // Post one update at a time, and wait for it to reach every subscriber.
+    // Latency is from post() until pop() on the client side.
+    void benchMonitor(size_t nconn) {
+        connect(nconn);
+
+        // clear any tag left by a previous run
+        pv.post(fill(0u));
+
+        Result res;
+        std::atomic<size_t> nrx{0u}, ninit{0u};
+        epicsEvent rxd;
+        std::vector<std::shared_ptr<client::Subscription>> subs;
+        std::vector<std::vector<double>> lats(nconn);
+
+        for(auto c : range(nconn)) {
+            auto& lat = lats[c];
+            lat.reserve(pay.niter);
+            subs.push_back(clis[c].monitor("bench")
+                           .maskConnected(true)
+                           .maskDisconnected(true)
+                           .event([&lat, &nrx, &ninit, &rxd](client::Subscription& sub) {
+                               while(auto update = sub.pop()) {
+                                   auto now(epicsMonotonicGet());
+                                   auto tag(update["timeStamp.secondsPastEpoch"].as<uint64_t>());
+                                   if(!tag) {
+                                       ninit++; // initial value
+                                   } else {
+                                       lat.push_back((now - tag)*1e-9);
+                                       nrx++;
+                                   }
+                                   rxd.signal();
+                               }
+                           })
+                           .exec());
+        }
+
+        // wait for initial updates to be delivered
+        while(ninit < nconn) {
+            if(!rxd.wait(5.0)) {
+                testDiag("MONITOR %s conn=%zu timeout waiting for initial update", pay.name, nconn);
+                break;
+            }
+        }
+
+        StopWatch W;
+        auto cpu0 = std::clock();
+        (void)W.click();
+
+        for(auto n : range(pay.niter)) {
+            pv.post(fill(epicsMonotonicGet()));
+
+            auto expect = (n+1u)*nconn;
+            while(nrx < expect) {
+                if(!rxd.wait(5.0)) {
+                    res.nfail++;
+                    break;
+                }
+            }
+        }
+
+        auto elapsed = W.click();
+        auto cpu = double(std::clock() - cpu0)/CLOCKS_PER_SEC;
+
+        for(auto& sub : subs)
+            sub->cancel();
+        subs.clear();
+
+        for(auto& lat : lats)
+            res.add(lat);
+
+        report("MONITOR", pay, nconn, res, elapsed, cpu);
+    }
+};
+
+} // namespace
+
+MAIN(benchnet)
+{
+    testPlan(0);
+    logger_config_env();
+
+    for(auto& pay : payloads) {
+        testDiag("Payload %s %zu bytes", pay.name, pay.nbytes());
+
+        Bench B(pay);
+
+        for(auto nconn : nconns) {
+            B.benchGet(nconn);
+            B.benchPut(nconn);
+            B.benchRPC(nconn);
+            B.benchMonitor(nconn);
+        }
+    }
+
+    cleanup_for_valgrind();
+    return testDone();
+}
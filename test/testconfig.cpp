@@ -113,8 +113,12 @@ void testDefs()
         conf.interfaces = {"1.2.3.4", "1.1.1.1"};
         conf.beaconDestinations = {"1.2.1.2", "4.3.2.1:1234"};
         conf.auto_beacon = false;
+        conf.memoryBudget = 1048576u;
+        conf.memoryBudgetDisconnect = true;
 
         conf.updateDefs(defs);
+        testEq(defs["EPICS_PVAS_MEMORY_BUDGET"], "1048576");
+        testEq(defs["EPICS_PVAS_MEMORY_BUDGET_DISCONNECT"], "YES");
         testEq(defs["EPICS_PVA_BROADCAST_PORT"], "1234");
         testEq(defs["EPICS_PVAS_BROADCAST_PORT"], "1234");
         testEq(defs["EPICS_PVA_SERVER_PORT"], "5678");
@@ -136,7 +140,11 @@ void testDefs()
         defs["EPICS_PVAS_AUTO_BEACON_ADDR_LIST"] = "NO";
         defs["EPICS_PVAS_BEACON_ADDR_LIST"] = "1.2.1.2 4.3.2.1:1234";
         defs["EPICS_PVAS_INTF_ADDR_LIST"] = "1.2.3.4 1.1.1.1";
+        defs["EPICS_PVAS_MEMORY_BUDGET"] = "1048576";
+        defs["EPICS_PVAS_MEMORY_BUDGET_DISCONNECT"] = "YES";
         conf.applyDefs(defs);
+        testEq(conf.memoryBudget, 1048576u);
+        testTrue(conf.memoryBudgetDisconnect);
         testEq(conf.udp_port, 1234);
         testEq(conf.tcp_port, 5678);
         testFalse(conf.auto_beacon);
@@ -179,7 +187,7 @@ void testClientAuto()
 
 MAIN(testconfig)
 {
-    testPlan(31);
+    testPlan(35);
     testSetup();
     testDefs();
     logger_config_env();
@@ -491,11 +491,116 @@ void testClear()
     testFalse(val.isMarked(true, true));
 }
 
+void testCloneMarked()
+{
+    testShow()<<__func__;
+
+    auto val = TypeDef(TypeCode::Struct, {
+                           members::UInt32("a"),
+                           members::String("b"),
+                           members::Struct("c", {
+                               members::Float64("x"),
+                               members::Float64A("y"),
+                           }),
+                           members::Union("d", {
+                               members::Int32("i"),
+                               members::String("s"),
+                           }),
+                       }).create();
+
+    val["a"] = 1u;
+    val["b"] = "unchanged";
+    val["c.x"] = 2.0;
+    val.unmark();
+
+    val["b"] = "changed";
+    val["c.y"] = shared_array<const double>({1.0, 2.0});
+    val["d->s"] = "sel";
+
+    auto copy(val.clone());
+    testFalse(copy["a"].isMarked());
+    testEq(copy["a"].as<uint32_t>(), 0u);
+    testTrue(copy["b"].isMarked());
+    testEq(copy["b"].as<std::string>(), "changed");
+    testFalse(copy["c.x"].isMarked());
+    testTrue(copy["c.y"].isMarked());
+    testEq(copy["c.y"].as<shared_array<const double>>().size(), 2u);
+    testEq(copy["d->s"].as<std::string>(), "sel");
+
+    // marking a sub-struct implies all of its members
+    val.unmark();
+    val["c"].mark();
+    copy = val.clone();
+    testTrue(copy["c"].isMarked());
+    testFalse(copy["b"].isMarked());
+    testTrue(copy["c.x"].isMarked());
+    testEq(copy["c.x"].as<double>(), 2.0);
+    testEq(copy["c.y"].as<shared_array<const double>>().size(), 2u);
+
+    // marking the top implies all fields
+    val.unmark();
+    val.mark();
+    copy = val.clone();
+    testTrue(copy.isMarked(false, false));
+    testEq(copy["a"].as<uint32_t>(), 1u);
+    testEq(copy["b"].as<std::string>(), "changed");
+    testEq(copy["c.x"].as<double>(), 2.0);
+    testEq(copy["d->s"].as<std::string>(), "sel");
+
+    // assign() into an existing Value of the same type
+    auto dest(val.cloneEmpty());
+    val.unmark();
+    val["c"].mark();
+    dest.assign(val);
+    testFalse(dest["a"].isMarked());
+    testEq(dest["c.x"].as<double>(), 2.0);
+}
+
+void testHandle()
+{
+    testShow()<<__func__;
+
+    TypeDef def(nt::NTScalar{TypeCode::Int32}.build());
+    auto val(def.create());
+
+    auto sevr(val.handle("alarm.severity"));
+    testTrue(sevr.valid());
+    testEq(sevr.name(), "alarm.severity");
+
+    val[sevr] = 2;
+    testEq(val["alarm.severity"].as<int32_t>(), 2);
+    testTrue(val["alarm.severity"].isMarked());
+
+    // same type
+    auto other(val.cloneEmpty());
+    other[sevr] = 3;
+    testEq(other["alarm.severity"].as<int32_t>(), 3);
+    testEq(val["alarm.severity"].as<int32_t>(), 2);
+
+    // similar type, falls back to lookup by name
+    auto similar(nt::NTScalar{TypeCode::Float64}.create());
+    similar[sevr] = 4;
+    testEq(similar["alarm.severity"].as<int32_t>(), 4);
+
+    // relative to a sub-structure
+    auto alarm(val["alarm"]);
+    auto rsevr(alarm.handle("severity"));
+    testEq(val["alarm"][rsevr].as<int32_t>(), 2);
+    testFalse(val[FieldHandle()].valid());
+
+    testThrows<LookupError>([&val]() {
+        (void)val.handle("nonexistent");
+    });
+    testThrows<NoField>([]() {
+        (void)Value().handle("value");
+    });
+}
+
 } // namespace
 
 MAIN(testdata)
 {
-    testPlan(156);
+    testPlan(187);
     testSetup();
     testTraverse();
     testAssign();
@@ -550,6 +655,8 @@ MAIN(testdata)
     testUnionMagicAssign();
     testExtract();
     testClear();
+    testCloneMarked();
+    testHandle();
     cleanup_for_valgrind();
     return testDone();
 }
@@ -4,9 +4,16 @@
  * in file LICENSE that is included with this distribution.
  */
 
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
 #include <testMain.h>
 
 #include <epicsUnitTest.h>
+#include <epicsThread.h>
 
 #include <pvxs/unittest.h>
 #include <pvxs/log.h>
@@ -15,6 +22,23 @@
 using namespace pvxs;
 namespace  {
 
+// runs fn on a new thread
+struct Runner : public epicsThreadRunable
+{
+    std::function<void()> fn;
+    epicsThread worker;
+    explicit Runner(std::function<void()>&& fn)
+        :fn(std::move(fn))
+        ,worker(*this, "runner", epicsThreadGetStackSize(epicsThreadStackBig))
+    {
+        worker.start();
+    }
+
+    void run() override final {
+        fn();
+    }
+};
+
 struct my_special_error : public std::runtime_error
 {
     my_special_error() : std::runtime_error("Special") {}
@@ -98,6 +122,82 @@ void test_call()
     testFalse(internal.tryCall([](){}));
 }
 
+void test_dispatch_order()
+{
+    testDiag("%s", __func__);
+
+    evbase base("TEST");
+
+    {
+        testDiag("Inline and heap allocated functors");
+        std::vector<int> order;
+        std::array<char, 256> big{};
+        big[0] = 'x';
+        base.dispatch([&order]() { order.push_back(1); });
+        base.dispatch([&order, big]() { order.push_back(big[0]=='x' ? 2 : -2); });
+        base.dispatch([&order]() { order.push_back(3); });
+        base.sync();
+        testEq(order.size(), 3u);
+        testOk(order==std::vector<int>({1, 2, 3}), "dispatch in order");
+    }
+
+    {
+        testDiag("More concurrent dispatch() than the ring can hold");
+        constexpr size_t nthread = 4u, nwork = 2000u;
+        std::vector<size_t> next(nthread, 0u);
+        size_t nbad = 0u;
+
+        std::vector<std::unique_ptr<Runner>> workers;
+        for(size_t t=0u; t<nthread; t++) {
+            workers.emplace_back(new Runner([&base, &next, &nbad, t]() {
+                for(size_t n=0u; n<nwork; n++) {
+                    base.dispatch([&next, &nbad, t, n]() {
+                        if(next[t]++ != n)
+                            nbad++;
+                    });
+                }
+            }));
+        }
+        for(auto& w : workers)
+            w->worker.exitWait();
+        base.sync();
+
+        size_t total = 0u;
+        for(auto n : next)
+            total += n;
+        testEq(total, nthread*nwork);
+        testEq(nbad, 0u)<<" out of order";
+    }
+}
+
+void test_join_race()
+{
+    testDiag("%s", __func__);
+
+    // call() concurrent with join() must either run, or fail, and never wait forever.
+    std::atomic<size_t> nok{0u}, nran{0u};
+    {
+        evbase base("TEST");
+        std::atomic<bool> go{false};
+
+        std::vector<std::unique_ptr<Runner>> workers;
+        for(size_t t=0u; t<4u; t++) {
+            workers.emplace_back(new Runner([&base, &go, &nok, &nran]() {
+                while(!go.load()) {}
+                while(base.tryCall([&nran]() { nran++; }))
+                    nok++;
+            }));
+        }
+        go = true;
+        epicsThreadSleep(0.01);
+        base.join();
+        for(auto& w : workers)
+            w->worker.exitWait();
+    }
+    testOk(nok.load()>0u, "%zu calls before join()", nok.load());
+    testEq(nran.load(), nok.load());
+}
+
 void test_fill_evbuf()
 {
     testDiag("%s", __func__);
@@ -142,15 +242,103 @@ void test_fill_evbuf()
     testEq(evbuffer_get_length(buf.get()), 0u);
 }
 
+void test_ref_evbuf()
+{
+    testDiag("%s", __func__);
+
+    shared_array<uint32_t> arr(1024u);
+    for(auto i : range(arr.size()))
+        arr[i] = i;
+    auto carr(arr.freeze().castTo<const void>());
+
+    for(bool be : {hostBE, !hostBE}) {
+        testDiag("BE=%c", be ? 'Y' : 'N');
+
+        evbuf buf(__FILE__, __LINE__, evbuffer_new());
+        {
+            EvOutBuf M(be, buf.get());
+            M.refThreshold = 256u;
+            to_wire<uint32_t>(M, carr);
+            testOk1(!!M.good());
+        }
+
+        testEq(evbuffer_get_length(buf.get()), 5u + 4*1024u);
+
+        // native byte order is appended by reference
+        evbuffer_iovec vecs[4];
+        auto nvec = evbuffer_peek(buf.get(), -1, nullptr, vecs, 4);
+        bool found = false;
+        for(auto i : range(std::min(nvec, 4))) {
+            found |= vecs[i].iov_base==carr.data() && vecs[i].iov_len==4*1024u;
+        }
+        testEq(found, be==hostBE);
+        // referenced array kept alive by evbuffer
+        testEq(carr.unique(), be!=hostBE);
+
+        (void)evbuffer_drain(buf.get(), evbuffer_get_length(buf.get()));
+        testTrue(carr.unique());
+    }
+}
+
+void test_copyout_evbuf()
+{
+    testDiag("%s", __func__);
+
+    for(bool be : {hostBE, !hostBE}) {
+        testDiag("BE=%c", be ? 'Y' : 'N');
+
+        std::vector<uint8_t> raw(1024u);
+        {
+            VectorOutBuf M(be, raw);
+            to_wire(M, Size{1000u});
+            for(uint32_t i : range(1000u))
+                to_wire(M, i);
+            testOk1(!!M.good());
+            raw.resize(M.consumed());
+        }
+
+        // spread across several evbuffer segments with unaligned boundaries
+        evbuf buf(__FILE__, __LINE__, evbuffer_new());
+        for(size_t pos = 0u; pos < raw.size(); pos += 333u) {
+            auto n = std::min(size_t(333u), raw.size()-pos);
+            evbuffer_add(buf.get(), raw.data()+pos, n);
+        }
+        testOk1(evbuffer_peek(buf.get(), -1, nullptr, nullptr, 0) > 1);
+
+        shared_array<const void> varr;
+        {
+            EvInBuf M(be, buf.get());
+            from_wire<uint32_t>(M, varr);
+            testOk1(!!M.good());
+        }
+        testEq(evbuffer_get_length(buf.get()), 0u);
+
+        auto arr(varr.castTo<const uint32_t>());
+        bool match = arr.size()==1000u;
+        for(auto i : range(std::min(arr.size(), size_t(1000u)))) {
+            if(arr[i]!=i) {
+                testDiag("[%u] %08x", unsigned(i), unsigned(arr[i]));
+                match = false;
+                break;
+            }
+        }
+        testOk(match, "decoded %u", unsigned(arr.size()));
+    }
+}
+
 } // namespace
 
 MAIN(testev)
 {
     SockAttach attach;
-    testPlan(20);
+    testPlan(46);
     testSetup();
     test_call();
+    test_dispatch_order();
+    test_join_race();
     test_fill_evbuf();
+    test_ref_evbuf();
+    test_copyout_evbuf();
     cleanup_for_valgrind();
     return testDone();
 }
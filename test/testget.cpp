@@ -6,12 +6,20 @@
 #define PVXS_ENABLE_EXPERT_API
 
 #include <atomic>
+#include <functional>
+#include <set>
+#include <sstream>
+
+#include <string.h>
 
 #include <testMain.h>
 
 #include <epicsUnitTest.h>
 
 #include <epicsEvent.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsThread.h>
 
 #include <pvxs/unittest.h>
 #include <pvxs/log.h>
@@ -25,6 +33,8 @@
 namespace {
 using namespace pvxs;
 
+typedef epicsGuard<epicsMutex> Guard;
+
 struct Tester {
     Value initial;
     server::SharedPV mbox;
@@ -512,11 +522,351 @@ void testError(bool phase)
     }
 }
 
+// runs fn on a new thread
+struct Runner : public epicsThreadRunable
+{
+    std::function<void()> fn;
+    epicsThread worker;
+    explicit Runner(std::function<void()>&& fn)
+        :fn(std::move(fn))
+        ,worker(*this, "runner", epicsThreadGetStackSize(epicsThreadStackBig))
+    {
+        worker.start();
+    }
+
+    void run() override final {
+        fn();
+    }
+};
+
+// Source which sets up operations from another thread while the TCP worker is busy
+struct AsyncSource : public server::Source
+{
+    const Value type;
+    std::atomic<bool> notBlocked{false};
+    AsyncSource()
+        :type(nt::NTScalar{TypeCode::Int32}.create())
+    {}
+
+    virtual void onSearch(Search &op) override final
+    {
+        for(auto& name : op) {
+            name.claim();
+        }
+    }
+    virtual void onCreate(std::unique_ptr<server::ChannelControl> &&op) override final
+    {
+        auto chan = std::move(op);
+
+        chan->onOp([this](std::unique_ptr<server::ConnectOp>&& op) {
+            std::shared_ptr<server::ConnectOp> setup(std::move(op));
+            epicsEvent returned;
+
+            Runner worker([this, setup, &returned]() {
+                setup->onGet([this](std::unique_ptr<server::ExecOp>&& op) {
+                    auto val(type.cloneEmpty());
+                    val["value"] = 17;
+                    op->reply(val);
+                });
+                setup->connect(type);
+                returned.signal();
+            });
+            // keep the TCP worker busy until connect() returns
+            notBlocked = returned.wait(5.0);
+            worker.worker.exitWait();
+        });
+    }
+};
+
+void testAsyncSetup()
+{
+    testShow()<<__func__;
+
+    auto src(std::make_shared<AsyncSource>());
+    auto serv = server::Config::isolated()
+            .build()
+            .addSource("async", src)
+            .start();
+
+    auto cli = serv.clientConfig().build();
+
+    testEq(cli.get("anything").exec()->wait(5.0)["value"].as<int32_t>(), 17);
+    testTrue(src->notBlocked)<<" connect() from another thread does not wait for the TCP worker";
+
+    cli.close();
+    serv.stop();
+}
+
+void testWorkers()
+{
+    testShow()<<__func__;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    initial["value"] = 42;
+    auto mbox(server::SharedPV::buildReadonly());
+    mbox.open(initial);
+
+    auto conf(server::Config::isolated());
+    conf.tcpWorkers = 2u;
+    auto serv = conf.build()
+            .addPV("mailbox", mbox)
+            .start();
+
+    testEq(serv.config().tcpWorkers, 2u);
+
+    // each Context opens one TCP connection, expected to be distributed to different workers
+    auto cli1 = serv.clientConfig().build();
+    auto cli2 = serv.clientConfig().build();
+
+    auto val1(cli1.get("mailbox").exec()->wait(5.0));
+    auto val2(cli2.get("mailbox").exec()->wait(5.0));
+
+    testEq(val1["value"].as<int32_t>(), 42);
+    testEq(val2["value"].as<int32_t>(), 42);
+
+    auto report(serv.report());
+    testEq(report.connections.size(), 2u);
+
+    std::ostringstream strm;
+    {
+        Detailed D(strm, 2);
+        strm<<serv;
+    }
+    auto show(strm.str());
+    testTrue(show.find("Worker0 connections=1")!=std::string::npos)<<show;
+    testTrue(show.find("Worker1 connections=1")!=std::string::npos)<<show;
+
+    // report() from handlers running concurrently on different workers
+    {
+        auto reporter(server::SharedPV::buildReadonly());
+        reporter.open(initial);
+        auto pserv = &serv;
+        reporter.onRPC([pserv](server::SharedPV&, std::unique_ptr<server::ExecOp>&& op, Value&&) {
+            auto report(pserv->report(false));
+            auto ret(nt::NTScalar{TypeCode::UInt32}.create());
+            ret["value"] = uint32_t(report.connections.size());
+            op->reply(ret);
+        });
+        serv.addPV("reporter", reporter);
+
+        auto op1(cli1.rpc("reporter").exec());
+        auto op2(cli2.rpc("reporter").exec());
+        testEq(op1->wait(5.0)["value"].as<uint32_t>(), 2u);
+        testEq(op2->wait(5.0)["value"].as<uint32_t>(), 2u);
+    }
+
+    // SharedPV::close() from handlers on each worker, of a PV with channels on the other
+    {
+        auto pva(server::SharedPV::buildReadonly());
+        auto pvb(server::SharedPV::buildReadonly());
+        pva.open(initial);
+        pvb.open(initial);
+
+        // rendezvous so that both handlers close() concurrently
+        epicsEvent readya, readyb;
+        auto closer = [](server::SharedPV& target, epicsEvent& mine, epicsEvent& other) {
+            return [target, &mine, &other](server::SharedPV&, std::unique_ptr<server::ExecOp>&& op, Value&&) mutable {
+                mine.signal();
+                (void)other.wait(5.0);
+                target.close();
+                op->reply();
+            };
+        };
+        auto closea(server::SharedPV::buildReadonly());
+        auto closeb(server::SharedPV::buildReadonly());
+        closea.onRPC(closer(pva, readya, readyb));
+        closeb.onRPC(closer(pvb, readyb, readya));
+        closea.open(initial);
+        closeb.open(initial);
+        serv.addPV("pva", pva)
+            .addPV("pvb", pvb)
+            .addPV("closea", closea)
+            .addPV("closeb", closeb);
+
+        for(auto cli : {&cli1, &cli2}) {
+            for(auto name : {"pva", "pvb"})
+                (void)cli->get(name).exec()->wait(5.0);
+        }
+
+        auto op1(cli1.rpc("closeb").exec());
+        auto op2(cli2.rpc("closea").exec());
+        try {
+            op1->wait(5.0);
+            op2->wait(5.0);
+            testPass("crossed close() replies");
+        } catch(std::exception& e) {
+            testFail("crossed close() : %s", e.what());
+        }
+        testFalse(pva.isOpen() || pvb.isOpen());
+    }
+
+    serv.stop();
+}
+
+// Source which is not indexed, and records what it is asked about
+struct SpySource : public server::Source
+{
+    server::SharedPV pv;
+    epicsMutex lock;
+    std::set<std::string> seen;
+
+    virtual void onSearch(Search &op) override final
+    {
+        Guard G(lock);
+        for(auto& name : op) {
+            seen.emplace(name.name());
+            if(strcmp(name.name(), "dyn")==0)
+                name.claim();
+        }
+    }
+    virtual void onCreate(std::unique_ptr<server::ChannelControl> &&op) override final
+    {
+        if(op->name()=="dyn")
+            pv.attach(std::move(op));
+    }
+    bool saw(const char* name)
+    {
+        Guard G(lock);
+        return seen.find(name)!=seen.end();
+    }
+};
+
+void testSearchIndex()
+{
+    testShow()<<__func__;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    initial["value"] = 42;
+    auto mbox(server::SharedPV::buildReadonly());
+    mbox.open(initial);
+
+    auto spy(std::make_shared<SpySource>());
+    spy->pv = server::SharedPV::buildReadonly();
+    spy->pv.open(initial.cloneEmpty().update("value", 7));
+
+    auto serv = server::Config::isolated()
+            .build()
+            .addPV("mailbox", mbox)
+            .addSource("spy", spy)
+            .start();
+
+    auto cli = serv.clientConfig().build();
+
+    testEq(cli.get("mailbox").exec()->wait(5.0)["value"].as<int32_t>(), 42);
+    testFalse(spy->saw("mailbox"))<<"name claimed from index is not passed to other Sources";
+
+    testEq(cli.get("dyn").exec()->wait(5.0)["value"].as<int32_t>(), 7);
+    testTrue(spy->saw("dyn"));
+
+    // index follows PVs added after start()
+    serv.addPV("later", mbox);
+    testEq(cli.get("later").exec()->wait(5.0)["value"].as<int32_t>(), 42);
+    testFalse(spy->saw("later"));
+
+    serv.stop();
+}
+
+void testTypeCache(size_t limit)
+{
+    testShow()<<__func__<<" limit="<<limit;
+
+    // same structure from distinct TypeDefs
+    auto mboxA(server::SharedPV::buildReadonly());
+    mboxA.open(nt::NTScalar{TypeCode::Int32}.create().update("value", 1));
+    auto mboxB(server::SharedPV::buildReadonly());
+    mboxB.open(nt::NTScalar{TypeCode::Int32}.create().update("value", 2));
+    auto mboxC(server::SharedPV::buildReadonly());
+    mboxC.open(nt::NTScalar{TypeCode::Float64}.create().update("value", 3.5));
+    auto mboxD(server::SharedPV::buildReadonly());
+    mboxD.open(nt::NTScalar{TypeCode::Int16}.create().update("value", 4));
+
+    auto conf(server::Config::isolated());
+    conf.txTypeCache = limit;
+    auto serv = conf.build()
+            .addPV("a", mboxA)
+            .addPV("b", mboxB)
+            .addPV("c", mboxC)
+            .addPV("d", mboxD)
+            .addPV("e", mboxD)
+            .start();
+
+    auto cli = serv.clientConfig().build();
+
+    testEq(cli.get("a").exec()->wait(5.0)["value"].as<int32_t>(), 1);
+    testEq(cli.get("b").exec()->wait(5.0)["value"].as<int32_t>(), 2);
+    testEq(cli.get("c").exec()->wait(5.0)["value"].as<double>(), 3.5);
+    testEq(cli.get("a").exec()->wait(5.0)["value"].as<int32_t>(), 1);
+
+    size_t hits = 0u, saved = 0u;
+    for(auto& conn : serv.report().connections) {
+        hits += conn.txTypeHits;
+        saved += conn.txTypeSaved;
+    }
+    testEq(hits, limit ? 2u : 0u);
+    testOk(!!saved == !!limit, "saved %zu", saved);
+
+    // The INIT reply to an operation cancelled by the client may still be sent,
+    // and may define a cached type.  Later references to that type must decode.
+    for(unsigned i=0u; i<10u; i++) {
+        auto op(cli.get("d").exec());
+        op->cancel();
+    }
+    testEq(cli.get("e").exec()->wait(5.0)["value"].as<int16_t>(), 4);
+
+    serv.stop();
+}
+
+void testSearchMany()
+{
+    testShow()<<__func__;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    initial["value"] = 42;
+    auto mbox(server::SharedPV::buildReadonly());
+    mbox.open(initial);
+
+    constexpr size_t npv = 2000u;
+
+    auto serv = server::Config::isolated().build();
+    for(auto i : range(npv))
+        serv.addPV(SB()<<"many:"<<i, mbox);
+    serv.start();
+
+    auto cli = serv.clientConfig().build();
+
+    epicsEvent done;
+    std::atomic<size_t> nconn{0u};
+    std::vector<std::shared_ptr<client::Connect>> conns;
+    conns.reserve(npv);
+    for(auto i : range(npv)) {
+        conns.push_back(cli.connect(SB()<<"many:"<<i)
+                        .onConnect([&nconn, &done]() {
+                            if(++nconn == npv)
+                                done.signal();
+                        })
+                        .exec());
+    }
+    auto missing(cli.connect("many:missing").exec());
+
+    testOk(done.wait(10.0), "Connected %zu/%zu", size_t(nconn), npv);
+
+    auto rpt(cli.report());
+    testEq(rpt.search.pending, 0u);
+    testEq(rpt.search.inFlight, 1u)<<" only many:missing";
+    testOk(rpt.search.resolved >= npv, "resolved %zu", rpt.search.resolved);
+    testOk(rpt.search.rate > 0.0, "rate %f", rpt.search.rate);
+
+    conns.clear();
+    missing.reset();
+    cli.close();
+    serv.stop();
+}
+
 } // namespace
 
 MAIN(testget)
 {
-    testPlan(62);
+    testPlan(99);
     testSetup();
     logger_config_env();
     const bool canIPv6 = pvxs::impl::evsocket::canIPv6;
@@ -539,6 +889,12 @@ MAIN(testget)
     Tester().ordering();
     testError(false);
     testError(true);
+    testAsyncSetup();
+    testWorkers();
+    testSearchIndex();
+    testTypeCache(4096u);
+    testTypeCache(0u);
+    testSearchMany();
     cleanup_for_valgrind();
     return testDone();
 }
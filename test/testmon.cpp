@@ -6,13 +6,16 @@
 #define PVXS_ENABLE_EXPERT_API
 
 #include <atomic>
+#include <limits>
 #include <typeinfo>
+#include <vector>
 
 #include <testMain.h>
 
 #include <epicsUnitTest.h>
 
 #include <epicsEvent.h>
+#include <epicsThread.h>
 
 #include <pvxs/unittest.h>
 #include <pvxs/log.h>
@@ -21,6 +24,7 @@
 #include <pvxs/sharedpv.h>
 #include <pvxs/source.h>
 #include <pvxs/nt.h>
+#include "utilpvt.h"
 
 namespace {
 using namespace pvxs;
@@ -292,8 +296,440 @@ struct TestLifeCycle : public BasicTest
             testFail("Missing data update");
         }
     }
+
+    void testFanout()
+    {
+        testShow()<<__func__;
+
+        // large enough to be referenced, not copied, into TX buffers
+        shared_array<double> arr(2048u);
+        for(size_t i=0u; i<arr.size(); i++)
+            arr[i] = i;
+
+        auto wave(server::SharedPV::buildReadonly());
+        auto proto(nt::NTScalar{TypeCode::Float64A}.create());
+        proto["value"] = arr.freeze();
+        proto["alarm.severity"] = 0;
+        wave.open(proto);
+        serv.addPV("wave", wave);
+
+        // second connection
+        auto cli2(serv.clientConfig().build());
+
+        epicsEvent evt1, evt2, evt3;
+        auto setup = [](client::Context& ctxt, epicsEvent& evt, const char* field) {
+            auto builder(ctxt.monitor("wave"));
+            if(field)
+                builder.field(field);
+            return builder.maskConnected(true)
+                    .maskDisconnected(false)
+                    .event([&evt](client::Subscription&) {
+                        evt.signal();
+                    })
+                    .exec();
+        };
+        // sub1 and sub2 have the same pvRequest, sub3 a different mask
+        auto sub1(setup(cli, evt1, nullptr));
+        auto sub2(setup(cli2, evt2, nullptr));
+        auto sub3(setup(cli, evt3, "alarm"));
+
+        cli.hurryUp();
+        cli2.hurryUp();
+
+        testEq(pop(sub1, evt1)["value"].as<shared_array<const double>>().size(), 2048u);
+        testEq(pop(sub2, evt2)["value"].as<shared_array<const double>>().size(), 2048u);
+        testFalse(pop(sub3, evt3)["value"].isMarked(false));
+
+        {
+            // also large enough to be referenced instead of copied by default
+            shared_array<double> arr2(16384u, 1.5);
+            auto update(proto.cloneEmpty());
+            update["value"] = arr2.freeze();
+            update["alarm.severity"] = 2;
+            wave.post(update);
+        }
+
+        for(auto pair : {std::make_pair(sub1, &evt1), std::make_pair(sub2, &evt2)}) {
+            auto val(pop(pair.first, *pair.second));
+            auto varr(val["value"].as<shared_array<const double>>());
+            testTrue(varr.size()==16384u && varr[0]==1.5 && varr[16383]==1.5)<<" size="<<varr.size();
+            testEq(val["alarm.severity"].as<int32_t>(), 2);
+        }
+        {
+            auto val(pop(sub3, evt3));
+            testFalse(val["value"].isMarked(false));
+            testEq(val["alarm.severity"].as<int32_t>(), 2);
+        }
+
+        sub1.reset();
+        sub2.reset();
+        sub3.reset();
+    }
 };
 
+// updates for many channels queued in quick succession are sent together
+void testCoalesce()
+{
+    testShow()<<__func__;
+
+    auto conf(server::Config::isolated());
+    conf.txCoalesceDelay = 0.05;
+    auto serv(conf.build());
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    initial["value"] = 0;
+
+    constexpr size_t npv = 20u;
+    std::vector<server::SharedPV> pvs;
+    for(auto i : range(npv)) {
+        pvs.push_back(server::SharedPV::buildReadonly());
+        pvs.back().open(initial);
+        serv.addPV(SB()<<"pv"<<i, pvs.back());
+    }
+    serv.start();
+
+    auto cli(serv.clientConfig().build());
+
+    epicsEvent evt;
+    std::vector<std::shared_ptr<client::Subscription>> subs;
+    for(auto i : range(npv)) {
+        subs.push_back(cli.monitor(SB()<<"pv"<<i)
+                       .maskConnected(true)
+                       .maskDisconnected(false)
+                       .event([&evt](client::Subscription&) {
+                           evt.signal();
+                       })
+                       .exec());
+    }
+    for(auto& sub : subs)
+        (void)BasicTest::pop(sub, evt);
+
+    (void)serv.report(true); // zero counters
+
+    for(auto& pv : pvs) {
+        auto update(initial.cloneEmpty());
+        update["value"] = 1;
+        pv.post(update);
+    }
+
+    bool ok = true;
+    for(auto& sub : subs)
+        ok &= BasicTest::pop(sub, evt)["value"].as<int32_t>()==1;
+    testTrue(ok);
+
+    auto report(serv.report());
+    if(testEq(report.connections.size(), 1u)) {
+        auto& conn = report.connections.front();
+        testTrue(conn.txMsgs>=npv)<<" txMsgs="<<conn.txMsgs;
+        testTrue(conn.txWrites>0u && conn.txWrites<conn.txMsgs)
+                <<" txMsgs="<<conn.txMsgs<<" txWrites="<<conn.txWrites;
+    } else {
+        testSkip(2, "No connection");
+    }
+}
+
+void testArrayPool()
+{
+    testShow()<<__func__;
+
+    auto initial(nt::NTScalar{TypeCode::Float64A}.create());
+    constexpr size_t nelem = 4096u;
+
+    auto fill = [&initial](double v) {
+        auto val(initial.cloneEmpty());
+        val["value"] = shared_array<const double>(nelem, v);
+        return val;
+    };
+
+    auto pv(server::SharedPV::buildReadonly());
+    pv.open(fill(0.0));
+    auto serv(server::Config::isolated().build().addPV("arr", pv).start());
+    auto cli(serv.clientConfig().build());
+
+    epicsEvent evt;
+    auto sub(cli.monitor("arr")
+             .maskConnected(true)
+             .maskDisconnected(false)
+             .event([&evt](client::Subscription&) {
+                 evt.signal();
+             })
+             .exec());
+
+    (void)BasicTest::pop(sub, evt);
+
+    constexpr size_t nupdate = 10u;
+    bool ok = true;
+    for(auto i : range(nupdate)) {
+        pv.post(fill(1.0+i));
+        // popped Value, and its array, released before next post()
+        auto arr(BasicTest::pop(sub, evt)["value"].as<shared_array<const double>>());
+        ok &= arr.size()==nelem && arr[0]==1.0+i && arr[nelem-1u]==1.0+i;
+    }
+    testTrue(ok)<<" received array content";
+
+    client::SubscriptionStat stats;
+    sub->stats(stats);
+    testEq(stats.nArrayReuse + stats.nArrayAlloc, nupdate+1u);
+    testTrue(stats.nArrayReuse >= nupdate-2u)
+            <<" nArrayReuse="<<stats.nArrayReuse<<" nArrayAlloc="<<stats.nArrayAlloc;
+}
+
+void testPostSnapshot()
+{
+    testShow()<<__func__;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    initial["value"] = 0;
+
+    auto pv(server::SharedPV::buildReadonly());
+    pv.open(initial);
+    auto serv(server::Config::isolated().build().addPV("snap", pv).start());
+    auto cli(serv.clientConfig().build());
+
+    epicsEvent evt;
+    auto sub(cli.monitor("snap")
+             .record("queueSize", 10)
+             .maskConnected(true)
+             .maskDisconnected(false)
+             .event([&evt](client::Subscription&) {
+                 evt.signal();
+             })
+             .exec());
+
+    (void)BasicTest::pop(sub, evt);
+
+    {
+        // sole reference, shared without copy
+        auto val(initial.cloneEmpty());
+        val["value"] = 1;
+        pv.post(std::move(val));
+    }
+    {
+        // caller keeps, and changes, its Value
+        auto val(initial.cloneEmpty());
+        val["value"] = 2;
+        pv.post(val);
+        val["value"] = -2;
+    }
+    {
+        // caller keeps a reference to a member field
+        auto val(initial.cloneEmpty());
+        auto fld(val["value"]);
+        fld = 3;
+        pv.post(std::move(val));
+        fld = -3;
+    }
+
+    testEq(BasicTest::pop(sub, evt)["value"].as<int32_t>(), 1);
+    testEq(BasicTest::pop(sub, evt)["value"].as<int32_t>(), 2);
+    testEq(BasicTest::pop(sub, evt)["value"].as<int32_t>(), 3);
+}
+
+void testExecMany()
+{
+    testShow()<<__func__;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+
+    constexpr size_t npv = 100u;
+    std::vector<server::SharedPV> pvs;
+    std::vector<std::string> names;
+    auto serv(server::Config::isolated().build());
+    for(auto i : range(npv)) {
+        pvs.push_back(server::SharedPV::buildReadonly());
+        pvs.back().open(initial.cloneEmpty().update("value", int32_t(i)));
+        names.push_back(SB()<<"many:"<<i);
+        serv.addPV(names.back(), pvs.back());
+    }
+    serv.start();
+    auto cli(serv.clientConfig().build());
+
+    epicsEvent evt;
+    auto subs(cli.monitor(std::string())
+              .record("queueSize", 2)
+              .maskConnected(true)
+              .maskDisconnected(false)
+              .event([&evt](client::Subscription&) {
+                  evt.signal();
+              })
+              .execMany(names));
+
+    testEq(subs.size(), npv);
+
+    bool ok = true;
+    for(auto i : range(npv)) {
+        auto& sub = subs[i];
+        ok &= sub->name()==names[i];
+        ok &= BasicTest::pop(sub, evt)["value"].as<size_t>()==i;
+    }
+    testTrue(ok)<<" Subscriptions in order, with initial values";
+
+    pvs[7].post(initial.cloneEmpty().update("value", -7));
+    testEq(BasicTest::pop(subs[7], evt)["value"].as<int32_t>(), -7);
+}
+
+void testLatency()
+{
+    testShow()<<__func__;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    initial["value"] = 0;
+
+    auto pv(server::SharedPV::buildReadonly());
+    pv.open(initial);
+    auto serv(server::Config::isolated().build().addPV("lat", pv).start());
+    auto cli(serv.clientConfig().build());
+
+    epicsEvent evt;
+    auto sub(cli.monitor("lat")
+             .record("queueSize", 10)
+             .maskConnected(true)
+             .maskDisconnected(false)
+             .event([&evt](client::Subscription&) {
+                 evt.signal();
+             })
+             .exec());
+
+    (void)BasicTest::pop(sub, evt);
+
+    for(auto i : range(1, 6)) {
+        pv.post(initial.cloneEmpty().update("value", i));
+        testDiag("pop %d", BasicTest::pop(sub, evt)["value"].as<int32_t>());
+    }
+
+    auto rpt(serv.report(false));
+    if(testOk1(rpt.connections.size()==1u)) {
+        auto& conn = rpt.connections.front();
+        testOk(conn.postToEncode.count==6u, "postToEncode.count %zu", conn.postToEncode.count);
+        testOk(conn.encodeToWrite.count>=6u, "encodeToWrite.count %zu", conn.encodeToWrite.count);
+        testOk(conn.postToEncode.p50<=conn.postToEncode.max && conn.postToEncode.max>0.0,
+               "p50 %g <= max %g", conn.postToEncode.p50, conn.postToEncode.max);
+        if(testOk1(conn.channels.size()==1u))
+            testEq(conn.channels.front().postToEncode.count, 6u);
+        else
+            testSkip(1, "no channel");
+    } else {
+        testSkip(5, "no connection");
+    }
+
+    // zero
+    (void)serv.report(true);
+    rpt = serv.report(false);
+    testEq(rpt.connections.front().postToEncode.count, 0u);
+}
+
+void testMaxRate()
+{
+    testShow()<<__func__;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    initial["value"] = 0;
+
+    auto pv(server::SharedPV::buildReadonly());
+    pv.open(initial);
+    auto serv(server::Config::isolated().build().addPV("rate", pv).start());
+    auto cli(serv.clientConfig().build());
+
+    epicsEvent evt;
+    auto sub(cli.monitor("rate")
+             .record("queueSize", 100)
+             .record("maxRate", 2.0)
+             .maskConnected(true)
+             .maskDisconnected(false)
+             .event([&evt](client::Subscription&) {
+                 evt.signal();
+             })
+             .exec());
+
+    testEq(BasicTest::pop(sub, evt)["value"].as<int32_t>(), 0);
+
+    // all within the 0.5 second interval following the initial update
+    for(auto i : range(1, 21))
+        pv.post(initial.cloneEmpty().update("value", i));
+    {
+        auto val(initial.cloneEmpty());
+        val["alarm.severity"] = 2;
+        pv.post(val);
+    }
+
+    size_t nupdate = 0u;
+    Value last;
+    while(!last || last["value"].as<int32_t>()!=20) {
+        last = BasicTest::pop(sub, evt);
+        nupdate++;
+    }
+
+    testOk(nupdate<=2u, "received %zu updates", nupdate);
+    testTrue(last["value"].isMarked(true, true) && last["alarm.severity"].isMarked(true, true))
+            <<" changes merged\n"<<last;
+    testEq(last["alarm.severity"].as<int32_t>(), 2);
+}
+
+void testMaxRateBounds()
+{
+    testShow()<<__func__;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    initial["value"] = 0;
+
+    auto pv(server::SharedPV::buildReadonly());
+    pv.open(initial);
+    auto serv(server::Config::isolated().build().addPV("rate", pv).start());
+    auto cli(serv.clientConfig().build());
+
+    // ignored, so no rate limit
+    for(double rate : {0.0, -1.0, std::numeric_limits<double>::quiet_NaN()}) {
+        testDiag("maxRate=%g", rate);
+        pv.post(initial.cloneEmpty().update("value", 0));
+
+        epicsEvent evt;
+        auto sub(cli.monitor("rate")
+                 .record("queueSize", 100)
+                 .record("maxRate", rate)
+                 .maskConnected(true)
+                 .maskDisconnected(false)
+                 .event([&evt](client::Subscription&) {
+                     evt.signal();
+                 })
+                 .exec());
+
+        (void)BasicTest::pop(sub, evt);
+
+        for(auto i : range(1, 4))
+            pv.post(initial.cloneEmpty().update("value", i));
+
+        size_t nupdate = 0u;
+        while(BasicTest::pop(sub, evt)["value"].as<int32_t>()!=3)
+            nupdate++;
+        testEq(nupdate+1u, 3u);
+    }
+
+    {
+        testDiag("subnormal maxRate");
+        pv.post(initial.cloneEmpty().update("value", 0));
+
+        epicsEvent evt;
+        auto sub(cli.monitor("rate")
+                 .record("maxRate", 1e-320)
+                 .maskConnected(true)
+                 .maskDisconnected(false)
+                 .event([&evt](client::Subscription&) {
+                     evt.signal();
+                 })
+                 .exec());
+
+        testEq(BasicTest::pop(sub, evt)["value"].as<int32_t>(), 0);
+
+        pv.post(initial.cloneEmpty().update("value", 1));
+        epicsThreadSleep(0.2);
+        testFalse(sub->pop())<<" update held by maxRate";
+
+        // cancel with rate timer armed
+        sub.reset();
+    }
+    serv.stop();
+}
+
 struct TestReconn : public BasicTest
 {
     void testReconn(bool closechan)
@@ -363,7 +799,7 @@ struct TestReconn : public BasicTest
 
 MAIN(testmon)
 {
-    testPlan(41);
+    testPlan(80);
     testSetup();
     try{
         logger_config_env();
@@ -375,6 +811,14 @@ MAIN(testmon)
         TestLifeCycle().testBasic(false);
         TestLifeCycle().testSecond();
         TestLifeCycle().testDelta();
+        TestLifeCycle().testFanout();
+        testCoalesce();
+        testArrayPool();
+        testPostSnapshot();
+        testExecMany();
+        testLatency();
+        testMaxRate();
+        testMaxRateBounds();
         TestReconn().testReconn(false);
         TestReconn().testReconn(true);
     }catch(std::exception& e) {
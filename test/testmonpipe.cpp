@@ -5,6 +5,8 @@
  */
 
 #include <algorithm>
+#include <limits>
+#include <vector>
 
 #include <string.h>
 
@@ -13,6 +15,9 @@
 #include <epicsUnitTest.h>
 
 #include <epicsEvent.h>
+#include <epicsThread.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
 
 #include <pvxs/unittest.h>
 #include <pvxs/log.h>
@@ -21,6 +26,7 @@
 #include <pvxs/sharedpv.h>
 #include <pvxs/source.h>
 #include <pvxs/nt.h>
+#include <pvxs/util.h>
 
 namespace {
 using namespace pvxs;
@@ -141,11 +147,332 @@ void testSpam(uint32_t nQueue, uint32_t highMark, uint16_t lastVal)
     testEq(expected, lastVal)<<" after Finish";
 }
 
+// holds the MonitorControlOp of the most recent subscription to "budget"
+struct BudgetSource : public server::Source {
+    Value prototype;
+    epicsMutex lock;
+    epicsEvent subscribed;
+    std::shared_ptr<server::MonitorControlOp> mctrl;
+
+    BudgetSource()
+        :prototype(nt::NTScalar{TypeCode::Float64A}.create())
+    {}
+
+    virtual void onSearch(Search &op) override final {
+        for(auto& pv : op) {
+            if(strcmp(pv.name(), "budget")==0)
+                pv.claim();
+        }
+    }
+
+    virtual void onCreate(std::unique_ptr<server::ChannelControl> &&rop) override final {
+        if(rop->name()!="budget")
+            return;
+
+        auto op(std::move(rop));
+        op->onSubscribe([this](std::unique_ptr<server::MonitorSetupOp>&& mop) {
+            std::shared_ptr<server::MonitorControlOp> ctrl(mop->connect(prototype));
+            {
+                epicsGuard<epicsMutex> G(lock);
+                mctrl = ctrl;
+            }
+            subscribed.signal();
+        });
+    }
+
+    Value update(size_t i) const {
+        shared_array<double> arr(1024u, double(i));
+        auto val(prototype.cloneEmpty());
+        val["value"] = arr.freeze();
+        return val;
+    }
+};
+
+void testBudget(bool disconnect)
+{
+    testShow()<<__func__<<" disconnect="<<disconnect;
+
+    auto src(std::make_shared<BudgetSource>());
+
+    auto conf(server::Config::isolated());
+    conf.memoryBudget = 1u; // always exceeded once anything is held
+    conf.memoryBudgetDisconnect = disconnect;
+    auto srv(conf.build()
+             .addSource("dut", src)
+             .start());
+
+    auto cli(srv.clientConfig().build());
+
+    epicsEvent wait;
+    auto mon(cli.monitor("budget")
+             .record("queueSize", 4)
+             .record("pipeline", true)
+             .maskConnected(true)
+             .maskDisconnected(false)
+             .event([&wait](client::Subscription&){
+                 wait.signal();
+             })
+             .exec());
+
+    if(!src->subscribed.wait(5.0))
+        testAbort("subscription timeout");
+    std::shared_ptr<server::MonitorControlOp> mctrl;
+    {
+        epicsGuard<epicsMutex> G(src->lock);
+        mctrl = src->mctrl;
+    }
+
+    // client does not pop(), so no more than the initial window of 4 is sent.
+    // Allow time to send, so that the window fills and the last update remains queued.
+    for(size_t i=0u; i<20u; i++) {
+        mctrl->post(src->update(i));
+        epicsThreadSleep(0.01);
+    }
+
+    if(disconnect) {
+        bool disconnected = false;
+        while(!disconnected && wait.wait(5.0)) {
+            try {
+                while(mon->pop()) {}
+            }catch(client::Disconnect&){
+                disconnected = true;
+            }
+        }
+        testTrue(disconnected)<<" client disconnected";
+        testSkip(2, "disconnect");
+
+    } else {
+        server::MonitorStat stat;
+        mctrl->stats(stat);
+        testEq(stat.maxQueue, 1u)<<" updates squashed while over budget";
+        testOk(stat.nSquash>0u, "nSquash %zu", stat.nSquash);
+
+        size_t held = 0u;
+        for(auto& conn : srv.report(false).connections)
+            held += conn.heldBytes;
+        testOk(held >= 1024u*sizeof(double), "heldBytes %zu", held);
+    }
+
+    mon->cancel();
+    srv.stop();
+}
+
+// one snapshot posted to several subscribers is not charged to each connection
+void testBudgetShared()
+{
+    testShow()<<__func__;
+
+    constexpr size_t nelem = 64u*1024u;
+    auto pv(server::SharedPV::buildReadonly());
+    auto initial(nt::NTScalar{TypeCode::Float64A}.create());
+    initial["value"] = shared_array<const double>(nelem, 0.0);
+    pv.open(initial);
+
+    auto conf(server::Config::isolated());
+    conf.memoryBudget = 1024u*1024u*1024u; // accounting, but never exceeded
+    auto srv(conf.build()
+             .addPV("shared", pv)
+             .start());
+
+    constexpr size_t nsub = 3u;
+    std::vector<client::Context> clis;
+    std::vector<std::shared_ptr<client::Subscription>> subs;
+    epicsEvent wait;
+    for(size_t i=0u; i<nsub; i++) {
+        clis.push_back(srv.clientConfig().build());
+        // client does not pop(), so the server queues beyond the initial window
+        subs.push_back(clis.back().monitor("shared")
+                       .record("queueSize", 2)
+                       .record("pipeline", true)
+                       .maskConnected(true)
+                       .maskDisconnected(false)
+                       .event([&wait](client::Subscription&){
+                           wait.signal();
+                       })
+                       .exec());
+    }
+    // wait for initial update on each
+    for(auto& sub : subs) {
+        while(!sub->pop()) {
+            if(!wait.wait(5.0))
+                testAbort("subscription timeout");
+        }
+    }
+
+    // first two fill the window.  Allow each to be sent, so that the last two
+    // are queued without squashing, which would make a private copy.
+    for(size_t n=1u; n<=4u; n++) {
+        auto val(initial.cloneEmpty());
+        val["value"] = shared_array<const double>(nelem, double(n));
+        pv.post(val);
+        epicsThreadSleep(0.05);
+    }
+    epicsThreadSleep(0.1);
+
+    // the last two are queued for every subscriber, and charged once to the server total
+    auto rpt(srv.report(false));
+    testEq(rpt.connections.size(), nsub);
+    size_t least = std::numeric_limits<size_t>::max();
+    for(auto& conn : rpt.connections)
+        least = std::min(least, conn.heldBytes);
+    testOk(least >= 2u*nelem*sizeof(double), "each connection references %zu bytes, at least two updates", least);
+
+    srv.stop();
+}
+
+// A client pinning shared updates is disconnected before one holding fewer private bytes
+void testBudgetSharedDisconnect()
+{
+    testShow()<<__func__;
+
+    constexpr size_t nelem = 64u*1024u;
+    auto shared(server::SharedPV::buildReadonly());
+    auto sinitial(nt::NTScalar{TypeCode::Float64A}.create());
+    sinitial["value"] = shared_array<const double>(nelem, 0.0);
+    shared.open(sinitial);
+
+    auto priv(server::SharedPV::buildReadonly());
+    auto pinitial(nt::NTScalar{TypeCode::Float64A}.create());
+    pinitial["value"] = shared_array<const double>(1024u, 0.0);
+    priv.open(pinitial);
+
+    auto conf(server::Config::isolated());
+    // exceeded by two shared updates queued for the slow client, but not by the private updates
+    conf.memoryBudget = 3u*nelem*sizeof(double)/2u;
+    conf.memoryBudgetDisconnect = true;
+    auto srv(conf.build()
+             .addPV("shared", shared)
+             .addPV("priv", priv)
+             .start());
+
+    auto cliFast(srv.clientConfig().build());
+    auto cliSlow(srv.clientConfig().build());
+    auto cliPriv(srv.clientConfig().build());
+
+    epicsEvent wFast, wSlow, wPriv;
+    auto subscribe = [](client::Context& cli, const char* name, epicsEvent& wait, bool pipeline) {
+        return cli.monitor(name)
+                .record("queueSize", 4)
+                .record("pipeline", pipeline)
+                .maskConnected(true)
+                .maskDisconnected(false)
+                .event([&wait](client::Subscription&){
+                    wait.signal();
+                })
+                .exec();
+    };
+    auto popAll = [](const std::shared_ptr<client::Subscription>& sub) -> bool {
+        try {
+            while(sub->pop()) {}
+            return false;
+        }catch(client::Disconnect&){
+            return true;
+        }
+    };
+    // one at a time, so that initial updates do not together exceed the budget
+    auto initial = [](const std::shared_ptr<client::Subscription>& sub, epicsEvent& wait) {
+        while(!sub->pop()) {
+            if(!wait.wait(5.0))
+                testAbort("subscription timeout");
+        }
+    };
+    // without pipeline, updates are not queued by the server for cliFast
+    auto subFast(subscribe(cliFast, "shared", wFast, false));
+    initial(subFast, wFast);
+    auto subSlow(subscribe(cliSlow, "shared", wSlow, true));
+    initial(subSlow, wSlow);
+    auto subPriv(subscribe(cliPriv, "priv", wPriv, true));
+    initial(subPriv, wPriv);
+
+    // once its window is full, private updates remain queued, as cliPriv does not pop()
+    for(size_t n=1u; n<=8u; n++) {
+        auto val(pinitial.cloneEmpty());
+        val["value"] = shared_array<const double>(1024u, double(n));
+        priv.post(val);
+        epicsThreadSleep(0.05);
+    }
+
+    // cliFast keeps up.  cliSlow does not pop(), so once its window is full, updates are queued for it.
+    for(size_t n=1u; n<=8u; n++) {
+        auto val(sinitial.cloneEmpty());
+        val["value"] = shared_array<const double>(nelem, double(n));
+        shared.post(val);
+        epicsThreadSleep(0.05);
+        (void)popAll(subFast);
+    }
+
+    // event() is only called when the queue becomes not empty, and popping lets more updates be sent.  So poll.
+    bool slowDisconnected = false;
+    for(unsigned i=0u; !slowDisconnected && i<50u; i++) {
+        slowDisconnected = popAll(subSlow);
+        if(!slowDisconnected)
+            (void)wSlow.wait(0.1);
+    }
+    testTrue(slowDisconnected)<<" client pinning shared updates disconnected";
+
+    epicsThreadSleep(0.1);
+    testFalse(popAll(subPriv))<<" client holding private updates remains connected";
+
+    srv.stop();
+}
+
+// Only a Value posted to more than one subscription is worth an UpdateCache entry
+void testUpdateCache(size_t nsub)
+{
+    testShow()<<__func__<<" nsub="<<nsub;
+
+    auto pv(server::SharedPV::buildReadonly());
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    initial["value"] = 0;
+    pv.open(initial);
+
+    auto srv(server::Config::isolated().build()
+             .addPV("shared", pv)
+             .start());
+
+    std::vector<client::Context> clis;
+    std::vector<std::shared_ptr<client::Subscription>> subs;
+    epicsEvent wait;
+    for(size_t i=0u; i<nsub; i++) {
+        clis.push_back(srv.clientConfig().build());
+        // client does not pop(), so the server queues beyond the initial window
+        subs.push_back(clis.back().monitor("shared")
+                       .record("queueSize", 2)
+                       .record("pipeline", true)
+                       .maskConnected(true)
+                       .maskDisconnected(false)
+                       .event([&wait](client::Subscription&){
+                           wait.signal();
+                       })
+                       .exec());
+    }
+    for(auto& sub : subs) {
+        while(!sub->pop()) {
+            if(!wait.wait(5.0))
+                testAbort("subscription timeout");
+        }
+    }
+
+    // the first fill the window.  The last remains queued.
+    for(int32_t n=1; n<=3; n++) {
+        pv.post(initial.cloneEmpty().update("value", n));
+        epicsThreadSleep(0.05);
+    }
+
+    auto nent(instanceSnapshot()["UpdateCacheEntry"]);
+    if(nsub==1u)
+        testEq(nent, 0u)<<" single subscriber skips the cache";
+    else
+        testOk(nent>=1u, "%zu cache entries queued", nent);
+
+    srv.stop();
+}
+
 } // namespace
 
 MAIN(testmonpipe)
 {
-    testPlan(99);
+    testPlan(111);
     testSetup();
     logger_config_env();
     testSpam(3u, 0u, 7u);
@@ -157,6 +484,12 @@ MAIN(testmonpipe)
     testSpam(4u, 3u, 10u);
     testSpam(4u, 4u, 10u);
     testSpam(4u, 6u, 10u);
+    testBudget(false);
+    testBudget(true);
+    testBudgetShared();
+    testBudgetSharedDisconnect();
+    testUpdateCache(1u);
+    testUpdateCache(2u);
     logger_config_env();
     cleanup_for_valgrind();
     return testDone();
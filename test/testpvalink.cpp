@@ -477,13 +477,28 @@ namespace {
         testdbGetFieldEqual("enum:tgt:b", DBR_STRING, "one");
         testTodoEnd();
     }
+
+    void testWorkers()
+    {
+        testDiag("==== %s ====", __func__);
+
+        if(testEq(linkGlobal->workers.size(), 2u)) {
+            for(auto& worker : linkGlobal->workers) {
+                Guard G(worker->lock);
+                testOk(worker->nrun>0u, "worker %zu runs=%zu maxQueue=%zu",
+                       worker->index, worker->nrun, worker->maxQueue);
+            }
+        } else {
+            testSkip(2, "Wrong number of workers");
+        }
+    }
 } // namespace
 
 extern "C" void testioc_registerRecordDeviceDriver(struct dbBase *);
 
 MAIN(testpvalink)
 {
-    testPlan(92);
+    testPlan(95);
     testSetup();
     pvxs::logger_config_env();
 
@@ -495,6 +510,9 @@ MAIN(testpvalink)
         testioc_registerRecordDeviceDriver(pdbbase);
         testdbReadDatabase("testpvalink.db", NULL, NULL);
 
+        // exercise processing of links spread across workers
+        pvaLinkNWorkers = 2;
+
         IOC.init();
 
         testGet();
@@ -512,6 +530,7 @@ MAIN(testpvalink)
         testFwd();
         testAtomic();
         testEnum();
+        testWorkers();
     }
     catch (std::exception &e)
     {
@@ -129,6 +129,114 @@ void testPvMask()
     testTrue(testmask(val, mask));
 }
 
+void testPlanTest()
+{
+    testDiag("%s", __func__);
+
+    auto val = nt::NTScalar{TypeCode::String}.create();
+
+    auto rdef = TypeDef(TypeCode::Struct, {
+                            members::Struct("field", {
+                                members::Struct("value", {}),
+                            })
+                        });
+
+    RequestPlan plan(Value::Helper::desc(val), rdef.create());
+    testEq(plan.mask, BitMask({0, 1}, 10u));
+
+    testFalse(plan.test(val));
+
+    val["alarm.status"].mark();
+    testFalse(plan.test(val));
+
+    val["value"].mark();
+    testTrue(plan.test(val));
+
+    val.unmark();
+    val.mark();
+    testTrue(plan.test(val));
+
+    testFalse(plan.test(Value()));
+}
+
+void testPlanCache()
+{
+    testDiag("%s", __func__);
+    namespace M = members;
+
+    auto val = nt::NTScalar{TypeCode::String}.create();
+    auto type = Value::Helper::type(val);
+
+    RequestPlanCache cache;
+
+    // separately built, but equivalent
+    auto req1 = TypeDef(TypeCode::Struct, {
+                            M::Struct("field", {
+                                M::Struct("timeStamp", {}),
+                                M::Struct("value", {}),
+                            })
+                        }).create();
+    auto req2 = TypeDef(TypeCode::Struct, {
+                            M::Struct("field", {
+                                M::Struct("value", {}),
+                                M::Struct("timeStamp", {}),
+                            })
+                        }).create();
+    auto req3 = TypeDef(TypeCode::Struct, {
+                            M::Struct("field", {
+                                M::Struct("value", {}),
+                            })
+                        }).create();
+
+    auto plan1(cache.lookup(type, req1));
+    auto plan2(cache.lookup(type, req2));
+    auto plan3(cache.lookup(type, req3));
+
+    testTrue(plan1==plan2)<<" equivalent requests share a plan";
+    testTrue(plan1!=plan3);
+    testEq(plan1->mask, request2mask(type.get(), req1));
+    testEq(plan3->mask, BitMask({0, 1}, 10u));
+    testEq(cache.nhit, 1u);
+    testEq(cache.nmiss, 2u);
+
+    {
+        // names not in the type are ignored, and don't add entries
+        auto junk1 = TypeDef(TypeCode::Struct, {
+                                 M::Struct("field", {
+                                     M::Struct("value", {}),
+                                     M::Struct("junk1", {}),
+                                 })
+                             }).create();
+        auto junk2 = TypeDef(TypeCode::Struct, {
+                                 M::Struct("field", {
+                                     M::Struct("junk2", {}),
+                                     M::Struct("value", {}),
+                                 })
+                             }).create();
+        testTrue(cache.lookup(type, junk1)==plan3);
+        testTrue(cache.lookup(type, junk2)==plan3);
+        testEq(cache.entries.size(), 2u);
+    }
+
+    // plans no longer used by any operation are purged
+    plan1.reset();
+    plan2.reset();
+    cache.purgeAt = cache.entries.size();
+    auto plan4(cache.lookup(type, req1));
+    testEq(cache.nmiss, 3u);
+    testEq(cache.entries.size(), 2u);
+    testEq(plan4->mask, request2mask(type.get(), req1));
+
+    auto bad = TypeDef(TypeCode::Struct, {
+                           M::Struct("field", {
+                               M::Struct("nonexistent", {}),
+                           })
+                       }).create();
+    testThrows<std::runtime_error>([&cache, &type, &bad](){
+        (void)cache.lookup(type, bad);
+    })<<" empty mask";
+}
+
 struct TestBuilder : client::detail::CommonBuilder<TestBuilder, client::detail::PRBase>
 {
     TestBuilder()
@@ -394,11 +502,13 @@ void testArgs()
 
 MAIN(testpvreq)
 {
-    testPlan(38);
+    testPlan(57);
     testSetup();
     logger_config_env();
     testPvRequest();
     testPvMask();
+    testPlanTest();
+    testPlanCache();
     testEmpty();
     testAssemble();
     testParseEmpty();
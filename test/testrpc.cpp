@@ -14,6 +14,9 @@
 #include <epicsUnitTest.h>
 
 #include <epicsEvent.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsThread.h>
 
 #include <pvxs/unittest.h>
 #include <pvxs/log.h>
@@ -269,14 +272,91 @@ struct Tester {
             testEq(result["implLang"].as<std::string>(), "cpp");
             testStrMatch("PVXS.*", result["version"].as<std::string>());
         }
+
+        {
+            auto result(cli.rpc("server", uri.call("latency"))
+                        .server(servaddr).exec()->wait(5.0));
+
+            auto peers(result["peer"].as<shared_array<const std::string>>());
+            auto count(result["encodeToWrite.count"].as<shared_array<const uint64_t>>());
+            testEq(peers.size(), 1u);
+            testOk(count.size()==1u && count[0]>0u, "encodeToWrite.count %s", std::string(SB()<<count).c_str());
+        }
     }
 };
 
+void testHandlerWorkers()
+{
+    testShow()<<__func__;
+
+    auto conf(server::Config::isolated());
+    conf.handlerWorkers = 2u;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    initial["value"] = 0;
+
+    auto mbox(server::SharedPV::buildMailbox());
+
+    epicsMutex lock;
+    std::vector<int32_t> seen;
+    std::string thread;
+
+    mbox.onRPC([&lock, &seen, &thread](server::SharedPV& pv, std::unique_ptr<server::ExecOp>&& op, Value&& arg) {
+        {
+            epicsGuard<epicsMutex> G(lock);
+            seen.push_back(arg["value"].as<int32_t>());
+            thread = epicsThreadGetNameSelf();
+        }
+        op->reply(arg);
+    });
+
+    auto serv(conf.build().addPV("mailbox", mbox));
+    mbox.open(initial);
+    serv.start();
+
+    auto cli(serv.clientConfig().build());
+
+    std::vector<std::shared_ptr<client::Operation>> ops;
+    std::vector<int32_t> expect;
+    for(int32_t i=1; i<=10; i++) {
+        auto arg(initial.cloneEmpty());
+        arg["value"] = i;
+        ops.push_back(cli.rpc("mailbox", arg).exec());
+        expect.push_back(i);
+    }
+    for(auto& op : ops)
+        op->wait(5.0);
+
+    {
+        epicsGuard<epicsMutex> G(lock);
+        testOk(seen==expect, "RPC handled in order");
+        testStrMatch("PVXHDL.*", thread);
+    }
+
+    testEq(cli.get("mailbox").exec()->wait(5.0)["value"].as<int32_t>(), 0);
+
+    auto report(serv.report());
+    if(testEq(report.handlers.size(), 2u)) {
+        size_t ncall = 0u;
+        for(auto& handler : report.handlers) {
+            ncall += handler.service.count;
+            testShow()<<"handler queued="<<handler.queued<<" maxQueued="<<handler.maxQueued
+                      <<" wait.p50="<<handler.wait.p50<<" service.p50="<<handler.service.p50;
+        }
+        testEq(ncall, 11u);
+    } else {
+        testSkip(1, "No handlers");
+    }
+
+    cli.close();
+    serv.stop();
+}
+
 } // namespace
 
 MAIN(testrpc)
 {
-    testPlan(23);
+    testPlan(30);
     testSetup();
     Tester().echo();
     Tester().lazy();
@@ -287,6 +367,7 @@ MAIN(testrpc)
     Tester().builder();
     Tester().orphan();
     Tester().serversrc();
+    testHandlerWorkers();
     cleanup_for_valgrind();
     return testDone();
 }
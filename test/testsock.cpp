@@ -241,6 +241,49 @@ void test_udp(int af)
     testEq(dest, bind_addr);
 }
 
+void test_udp_many(int af)
+{
+    testDiag("Enter %s(%d)", __func__, af);
+
+    evsocket A(af, SOCK_DGRAM, 0, true),
+             B(af, SOCK_DGRAM, 0, true);
+
+    SockAddr bind_addr(SockAddr::loopback(af));
+    A.enable_IP_PKTINFO();
+    A.bind(bind_addr);
+
+    SockAddr send_addr(SockAddr::loopback(af));
+    B.bind(send_addr);
+
+    uint8_t msg[] = {0x12, 0x34, 0x56, 0x78};
+    const SockAddr* dests[] = {&bind_addr, &bind_addr, &bind_addr};
+    auto nsent = sendtoMany(B.sock, msg, sizeof(msg), dests, 3u);
+    testEq(nsent, 3u)<<" sendtoMany()";
+
+    uint8_t rxbuf[4][8] = {};
+    SockAddr src[4], dest[4];
+    recvfromx rx[4];
+    for(size_t i=0u; i<4u; i++)
+        rx[i] = recvfromx{A.sock, (char*)rxbuf[i], sizeof(rxbuf[i]), &src[i], &dest[i]};
+
+    size_t nrx = 0u;
+    while(nrx < 3u && waitReadable(A)) {
+        auto ret = recvfromx::callMany(rx + nrx, 4u - nrx);
+        testDiag("callMany() -> %d", ret);
+        if(ret<=0)
+            break;
+        nrx += size_t(ret);
+    }
+    testEq(nrx, 3u)<<" callMany()";
+
+    for(size_t i=0u; i<nrx; i++) {
+        testOk(rx[i].nrx==4 && !memcmp(rxbuf[i], msg, sizeof(msg)),
+               "Recv'd[%zu] %d [%u, %u, %u, %u]", i, rx[i].nrx,
+               rxbuf[i][0], rxbuf[i][1], rxbuf[i][2], rxbuf[i][3]);
+        testEq(src[i], send_addr);
+    }
+}
+
 void test_local_mcast()
 {
     testDiag("Enter %s", __func__);
@@ -494,7 +537,7 @@ MAIN(testsock)
 {
     SockAttach attach;
     logger_config_env();
-    testPlan(92);
+    testPlan(100);
     testSetup();
     testEndPoint();
     // check for behavior when binding ipv4 and ipv6 to the same socket
@@ -532,6 +575,7 @@ MAIN(testsock)
     }catch(std::exception&e){
         testAbort("test_udp6: %s", e.what());
     }
+    test_udp_many(AF_INET);
     test_local_mcast();
     test_mcast_scope();
     test_from_wire();
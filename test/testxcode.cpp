@@ -1214,11 +1214,75 @@ void testEmptyRequest()
            "[0] struct  parent=[0]  [0:1)\n")<<"\nActual descs2\n"<<descs2.data();
 }
 
+void testSwapCopy()
+{
+    auto impls(swapCopyImpls());
+    testDiag("%s using %s", __func__, swapCopyImpl());
+    for(auto& impl : impls)
+        testDiag("  available %s", impl.c_str());
+
+    testOk(!impls.empty() && impls.front()==swapCopyImpl(), "selected implementation is available");
+
+    std::vector<uint8_t> input(8u*67u);
+    for(auto i : range(input.size()))
+        input[i] = uint8_t(i);
+
+    for(size_t esize : {2u, 4u, 8u}) {
+        bool ok = true, okInPlace = true;
+
+        // every implementation, and the selected one through swapCopy().
+        // Each length up to two vectors, to exercise vector body and scalar tail, and one long odd length.
+        impls.emplace_back();
+        for(auto& impl : impls) {
+            std::vector<size_t> lengths;
+            for(size_t nbytes=0u; nbytes<=64u; nbytes+=esize)
+                lengths.push_back(nbytes);
+            lengths.push_back(input.size());
+
+            for(auto nbytes : lengths) {
+                std::vector<uint8_t> expect(nbytes);
+                for(size_t i=0u; i<nbytes; i+=esize) {
+                    for(size_t n=0u; n<esize; n++)
+                        expect[i + esize-1u-n] = input[i + n];
+                }
+
+                std::vector<uint8_t> actual(nbytes);
+                if(impl.empty())
+                    swapCopy(actual.data(), input.data(), nbytes, esize);
+                else
+                    swapCopyWith(impl, actual.data(), input.data(), nbytes, esize);
+                if(actual!=expect) {
+                    ok = false;
+                    testDiag("Error %s swap%zu of %zu bytes", impl.c_str(), esize, nbytes);
+                }
+
+                actual.assign(input.begin(), input.begin()+nbytes);
+                if(impl.empty())
+                    swapCopy(actual.data(), actual.data(), nbytes, esize);
+                else
+                    swapCopyWith(impl, actual.data(), actual.data(), nbytes, esize);
+                if(actual!=expect) {
+                    okInPlace = false;
+                    testDiag("Error %s swap%zu of %zu bytes in place", impl.c_str(), esize, nbytes);
+                }
+            }
+        }
+        impls.pop_back();
+
+        testOk(ok, "swapCopy(%zu) with %zu implementations", esize, impls.size());
+        testOk(okInPlace, "swapCopy(%zu) in place with %zu implementations", esize, impls.size());
+    }
+
+    testThrows<std::logic_error>([&input](){
+        swapCopyWith("nonexistent", input.data(), input.data(), input.size(), 2u);
+    });
+}
+
 } // namespace
 
 MAIN(testxcode)
 {
-    testPlan(143);
+    testPlan(151);
     testSetup();
     testDeserializeString();
     testSerialize1();
@@ -1229,6 +1293,7 @@ MAIN(testxcode)
     testDeserialize3();
     testDecode1();
     testArrayXCode();
+    testSwapCopy();
     testXCodeNTScalar();
     testXCodeNTNDArray();
     testRegressRedundantBitMask();